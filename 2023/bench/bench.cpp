@@ -0,0 +1,31 @@
+#include "bench.hpp"
+
+#include "solvelib/06/day06_bench.hpp"
+#include "solvelib/17/day17_bench.hpp"
+#include "xmaslib/matrix/dense_algebra_bench.hpp"
+#include "xmaslib/matrix/padded_grid_bench.hpp"
+#include "xmaslib/matrix/text_matrix_bench.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+// Usage: bench [NAME...]
+// Runs the benchmarks whose name contains any of the arguments, or all of them
+// if there are none.
+int main(int argc, char** argv) {
+  std::vector<std::string_view> filters(argv + 1, argv + argc);
+
+  xlog::info("{:<24} {:<16} {:>8} {:>12}", "BENCHMARK", "VARIANT", "COUNT", "MEAN(ns)");
+  for (auto const& b : bench::registered()) {
+    const bool selected = filters.empty() || std::ranges::any_of(filters, [&](std::string_view f) {
+      return b.name.find(f) != std::string_view::npos;
+    });
+    if (selected) {
+      b.run();
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "xmaslib/log/log.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace bench {
+
+using clock = std::chrono::high_resolution_clock;
+
+// do_not_optimize prevents the compiler from discarding a value that is otherwise unused
+template <typename T>
+void do_not_optimize(T const& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct stats {
+  std::int64_t iterations;
+  std::int64_t mean_ns;
+};
+
+// run executes f repeatedly for at least min_time and returns its mean runtime
+template <typename F>
+stats run(F&& f, clock::duration min_time = std::chrono::milliseconds(500)) {
+  std::int64_t iter = 0;
+  const auto begin = clock::now();
+  auto elapsed = clock::duration{};
+  do {
+    f();
+    ++iter;
+    elapsed = clock::now() - begin;
+  } while (elapsed < min_time);
+
+  return {
+    .iterations = iter,
+    .mean_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / iter,
+  };
+}
+
+inline void report(std::string_view name, std::string_view variant, stats s) {
+  xlog::info("{:<24} {:<16} {:>8} {:>12}", name, variant, s.iterations, s.mean_ns);
+}
+
+struct benchmark {
+  std::string_view name;
+  std::function<void()> run;
+};
+
+inline std::vector<benchmark>& registered() {
+  static std::vector<benchmark> benchmarks;
+  return benchmarks;
+}
+
+// Instantiate a registration at namespace scope to add a benchmark to the executable
+struct registration {
+  registration(std::string_view name, std::function<void()> run) {
+    registered().push_back({name, std::move(run)});
+  }
+};
+
+} // namespace bench
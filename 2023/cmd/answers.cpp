@@ -0,0 +1,178 @@
+#include "answers.hpp"
+
+#include "xmaslib/cache/cache.hpp"
+#include "xmaslib/log/log.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+namespace app::answers {
+
+namespace {
+
+// One line per entry: day, part, input hash, build id, answer and nanoseconds
+constexpr auto store_path = "./.cache/answers.txt";
+
+struct key {
+  int day;
+  int part;
+  std::uint64_t input_hash;
+  std::uint64_t build_id;
+
+  auto operator<=>(key const&) const = default;
+};
+
+bool active = false;
+bool dirty = false;
+bool refreshing = false;
+double verify_probability = 0;
+std::uint64_t build = 0;
+std::map<key, entry> entries;
+std::mt19937_64 rng{std::random_device{}()};
+
+// Hash of the binary that is running, so that rebuilding the solvers invalidates their answers
+std::uint64_t build_id() {
+  std::ifstream f("/proc/self/exe", std::ios::binary);
+  if (!f) {
+    xlog::warning("could not read the aoc2023 binary, answers are keyed by build time instead");
+    return xmas::cache::hash(__DATE__ " " __TIME__);
+  }
+  std::stringstream buff;
+  buff << f.rdbuf();
+  return xmas::cache::hash(std::move(buff).str());
+}
+
+void load() {
+  std::ifstream f(store_path);
+  if (!f) {
+    return;
+  }
+
+  key k;
+  entry e;
+  std::int64_t ns = 0;
+  while (f >> k.day >> k.part >> std::hex >> k.input_hash >> k.build_id >> std::dec >> e.answer
+         >> ns) {
+    e.time = xmas::solution::duration(ns);
+    entries[k] = e;
+  }
+
+  if (!f.eof()) {
+    xlog::warning("{} is corrupt, some memoized answers were lost", store_path);
+    dirty = true;
+  }
+}
+
+} // namespace
+
+void enable(double verify_fraction, bool refresh) {
+  active = true;
+  refreshing = refresh;
+  verify_probability = verify_fraction;
+  build = build_id();
+  load();
+}
+
+bool enabled() noexcept {
+  return active;
+}
+
+std::optional<std::array<entry, 2>> lookup(int day, std::string_view input) {
+  if (refreshing) {
+    return {};
+  }
+
+  const auto input_hash = xmas::cache::hash(input);
+  std::array<entry, 2> out;
+  for (int part : {1, 2}) {
+    auto it = entries.find(key{day, part, input_hash, build});
+    if (it == entries.end()) {
+      return {};
+    }
+    out[std::size_t(part - 1)] = it->second;
+  }
+
+  if (std::bernoulli_distribution(verify_probability)(rng)) {
+    xlog::debug("verifying the memoized answers of day {}", day);
+    return {};
+  }
+
+  return out;
+}
+
+bool record(xmas::solution& s, std::string_view input) {
+  const auto input_hash = xmas::cache::hash(input);
+  bool consistent = true;
+
+  for (int part : {1, 2}) {
+    const auto answer = s.answer(part);
+    if (!answer.has_value()) {
+      continue;
+    }
+
+    const key k{s.day(), part, input_hash, build};
+    const entry e{*answer, s.part_time(part)};
+    auto [it, inserted] = entries.try_emplace(k, e);
+    if (inserted) {
+      dirty = true;
+      continue;
+    }
+
+    if (it->second.answer != e.answer && !refreshing) {
+      xlog::error("day {} part {}: memoized answer was {}, but it is {}", s.day(), part,
+        it->second.answer, e.answer);
+      consistent = false;
+    }
+    if (it->second.answer != e.answer || it->second.time != e.time) {
+      it->second = e;
+      dirty = true;
+    }
+  }
+
+  return consistent;
+}
+
+void save() {
+  if (!active || !dirty) {
+    return;
+  }
+
+  const std::filesystem::path path(store_path);
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+
+  // Entries of other builds can never be looked up again, so they are dropped
+  const std::string tmp = xmas::cache::temporary_path(store_path);
+  {
+    std::ofstream f(tmp);
+    for (auto const& [k, e] : entries) {
+      if (k.build_id == build) {
+        f << std::format("{} {} {:016x} {:016x} {} {}\n", k.day, k.part, k.input_hash, k.build_id,
+          e.answer, e.time.count());
+      }
+    }
+    if (!f.flush()) {
+      xlog::warning("could not write {}: {}", tmp, std::strerror(errno));
+      std::filesystem::remove(tmp, ec);
+      return;
+    }
+  }
+
+  std::filesystem::rename(tmp, path, ec);
+  if (ec) {
+    xlog::warning("could not write {}: {}", store_path, ec.message());
+    std::filesystem::remove(tmp, ec);
+    return;
+  }
+  dirty = false;
+}
+
+} // namespace app::answers
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "xmaslib/solution/solution.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// answers memoizes the answers of the solutions across runs, in a local file. Entries are
+// keyed by day, part, a hash of the input and a hash of the aoc2023 binary itself, so that
+// changing either the input or the solver makes them unreachable.
+namespace app::answers {
+
+struct entry {
+  std::uint64_t answer;
+  xmas::solution::duration time; // Time it took to solve it
+};
+
+// Loads the store. Memoized days are re-solved anyway with probability verify_fraction, to
+// detect stale entries. With refresh, all days are re-solved and their entries replaced.
+void enable(double verify_fraction, bool refresh);
+[[nodiscard]] bool enabled() noexcept;
+
+// The memoized answers of both parts of a day, unless they are missing or the day was picked
+// for verification
+[[nodiscard]] std::optional<std::array<entry, 2>> lookup(int day, std::string_view input);
+
+// Memoizes the answers of the last run of a solution. Returns false (and logs why) if they
+// differ from the memoized ones.
+bool record(xmas::solution& s, std::string_view input);
+
+// Writes the store back to disk, if anything changed
+void save();
+
+} // namespace app::answers
@@ -1,20 +1,65 @@
 #include "cmd.hpp"
+#include "answers.hpp"
+#include "memory.hpp"
+#include "perf.hpp"
 #include "solvelib/alldays.hpp"
 #include "xmaslib/log/log.hpp"
 #include "xmaslib/solution/solution.hpp"
 
+#include <algorithm>
+#include <array>
 #include <charconv>
 #include <chrono>
 #include <cmath>
+#include <format>
+#include <fstream>
+#include <future>
 #include <memory>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 
 namespace app {
 
+// Solves a day, with its input already read if given
 std::optional<xmas::solution::duration> solve_day(
   std::map<const int, std::unique_ptr<xmas::solution>>::value_type const& solution,
-  bool verbose);
+  bool verbose, std::optional<std::string> input = {});
+
+std::string input_path(int day) {
+  return std::format("./data/{:02d}/input.txt", day);
+}
+
+// The input of a day. Empty if it cannot be read, in which case solving the day will report why.
+std::optional<std::string> read_input(int day) {
+  std::ifstream f(input_path(day));
+  if (!f) {
+    return {};
+  }
+  std::stringstream buff;
+  buff << f.rdbuf();
+  return std::move(buff).str();
+}
+
+// Reads the input of a day in another thread, so that it is ready once the days before it
+// are solved
+std::future<std::optional<std::string>> prefetch_input(int day) {
+  // Memory tracking attributes allocations on any thread to the part running at the time, so
+  // the input is then read when it is needed instead
+  const auto policy = memory::enabled() ? std::launch::deferred : std::launch::async;
+  return std::async(policy, read_input, day);
+}
+
+// Logs memoized answers the same way as solution::run
+void report_memoized(int day, std::array<answers::entry, 2> const& memo) {
+  xlog::info("Day {} (memoized)", day);
+  for (std::size_t part = 0; part < memo.size(); ++part) {
+    xlog::info("Result {}: {} ({} μs)", part + 1, memo[part].answer,
+      std::chrono::duration_cast<std::chrono::microseconds>(memo[part].time).count());
+  }
+}
 
 solution_vector select_all_days() {
   try {
@@ -68,16 +113,48 @@ bool execute_days(app&, solution_vector const& days) {
   xmas::solution::duration total{};
   bool total_success = true;
 
-  for (auto d : days) {
-    const auto t = solve_day(*d, true);
+  std::future<std::optional<std::string>> next;
+  if (!days.empty()) {
+    next = prefetch_input(days.front()->second->day());
+  }
+
+  for (std::size_t i = 0; i < days.size(); ++i) {
+    auto d = days[i];
+    const int day = d->second->day();
+
+    auto input = next.get();
+    if (i + 1 < days.size()) {
+      next = prefetch_input(days[i + 1]->second->day());
+    }
+
+    if (input.has_value() && answers::enabled()) {
+      if (auto memo = answers::lookup(day, *input); memo.has_value()) {
+        report_memoized(day, *memo);
+        continue;
+      }
+    }
+
+    std::optional<xmas::solution::duration> t;
+    if (input.has_value() && answers::enabled()) {
+      // The input is still needed to memoize the answers
+      t = solve_day(*d, true, input);
+      // Answers that disagree with memoized ones are reported, and the newer ones kept
+      total_success = answers::record(*d->second, *input) && total_success;
+    } else {
+      t = solve_day(*d, true, std::move(input));
+    }
+
     if (!t.has_value()) {
       total_success = false;
       continue;
     }
 
     total += *t;
+    total_success = memory::report(day) && total_success;
   }
 
+  answers::save();
+
   xlog::info("DONE");
   xlog::info(
     "Total time was {} ms", std::chrono::duration_cast<std::chrono::milliseconds>(total).count());
@@ -89,6 +166,15 @@ std::int64_t microseconds(xmas::solution::duration d) {
   return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
 }
 
+// Formats an optional column of the timing table
+std::string column(std::optional<double> value) {
+  return value.has_value() ? std::format("{:.2f}", *value) : "-";
+}
+
+std::string column(bool available, std::uint64_t value) {
+  return available ? std::format("{}", value) : "-";
+}
+
 bool time_days(app&, solution_vector const& days, xmas::solution::duration timeout) {
   xmas::solution::duration total{};
   bool total_success = true;
@@ -99,9 +185,11 @@ bool time_days(app&, solution_vector const& days, xmas::solution::duration timeo
              "evaluate its performance.",
     std::chrono::duration_cast<std::chrono::seconds>(timeout).count());
 
-  constexpr std::string_view fmt = "{:>7} {:>8} {:>7}    {:>7}";
+  constexpr std::string_view fmt =
+    "{:>7} {:>8} {:>7}    {:>7}        {:>9} {:>9} {:>9} {:>9} {:>5} {:>9} {:>9} {:>8}";
   xlog::info("");
-  xlog::info("    DAY    COUNT  MEAN(μs)  DEVIATION(μs)");
+  xlog::info("    DAY    COUNT  MEAN(μs)  DEVIATION(μs)  SCRATCH(#)   HEAP(#) ALLOCS(#) PEAK(KiB)"
+             "   IPC L1D(MPKI) LLC(MPKI) BR(MPKI)");
 
   for (auto d : days) {
     auto begin = std::chrono::high_resolution_clock::now();
@@ -112,19 +200,56 @@ bool time_days(app&, solution_vector const& days, xmas::solution::duration timeo
     // Used to compute standard deviation
     std::int64_t M = 0, S = 0;
 
+    // Allocations served by the scratch arena, and those it had to make on the heap
+    std::uint64_t scratch_allocs = 0, heap_allocs = 0;
+
+    // Global allocations, only if memory tracking is enabled
+    std::uint64_t allocs = 0;
+    std::array<std::uint64_t, 2> peak{};
+
+    // Hardware counters, only if they are enabled
+    std::optional<perf::sample> counters;
+
     // Disable warning and debug messages (They'll be spammed because
     // the soultion is re-run many times)
     xlog::logger::global().set_severity(xlog::ERROR);
 
     while (std::chrono::high_resolution_clock::now() - begin < timeout) {
+      if (perf::enabled()) {
+        perf::start();
+      }
+
       const auto t = solve_day(*d, false);
       if (!t.has_value()) {
+        if (perf::enabled()) {
+          // The counters of a failed run are discarded, but they must stop anyway
+          (void)perf::stop();
+        }
         total_success = false;
         continue;
       }
       daily_total += *t;
       ++iter;
 
+      if (perf::enabled()) {
+        const auto sample = perf::stop();
+        if (counters.has_value()) {
+          *counters += sample;
+        } else {
+          counters = sample;
+        }
+      }
+
+      const auto scratch = d->second->scratch_stats();
+      scratch_allocs += scratch.allocations;
+      heap_allocs += scratch.heap_allocations;
+
+      const auto usage = memory::last_run();
+      for (std::size_t part = 0; part < usage.size(); ++part) {
+        allocs += usage[part].allocations;
+        peak[part] = std::max(peak[part], usage[part].peak_bytes);
+      }
+
       // std deviation stuff
       // https://mathcentral.uregina.ca/QQ/database/QQ.09.02/carlos1.html
       auto us = microseconds(*t);
@@ -146,23 +271,42 @@ bool time_days(app&, solution_vector const& days, xmas::solution::duration timeo
     const auto dev = static_cast<std::int64_t>(std::sqrt(S / iter));
 
     // Report
-    xlog::info(fmt, d->second->day(), iter, mean, dev);
+    const auto uiter = static_cast<std::uint64_t>(iter);
+    const auto hw = counters.value_or(perf::sample{});
+    xlog::info(fmt, d->second->day(), iter, mean, dev, scratch_allocs / uiter, heap_allocs / uiter,
+      column(memory::enabled(), allocs / uiter),
+      column(memory::enabled(), std::ranges::max(peak) / 1024), column(hw.ipc()),
+      column(hw.mpki(perf::l1d_misses)), column(hw.mpki(perf::llc_misses)),
+      column(hw.mpki(perf::branch_misses)));
+
+    if (memory::enabled()) {
+      for (std::size_t part = 0; part < peak.size(); ++part) {
+        total_success =
+          memory::check_budget(d->second->day(), int(part + 1), peak[part]) && total_success;
+      }
+    }
 
     total += daily_total / iter;
   }
 
-  xlog::info(
-    fmt, "TOTAL", "-", std::chrono::duration_cast<std::chrono::microseconds>(total).count(), "-");
+  xlog::info(fmt, "TOTAL", "-",
+    std::chrono::duration_cast<std::chrono::microseconds>(total).count(), "-", "-", "-", "-", "-",
+    "-", "-", "-", "-");
 
   return total_success;
 }
 
 std::optional<xmas::solution::duration> solve_day(
   std::map<const int, std::unique_ptr<xmas::solution>>::value_type const& solution,
-  bool verbose) {
+  bool verbose, std::optional<std::string> input) {
 
   try {
-    solution.second->set_input(std::format("./data/{:02d}/input.txt", solution.second->day()));
+    const auto path = input_path(solution.second->day());
+    if (input.has_value()) {
+      solution.second->set_prefetched_input(path, std::move(*input));
+    } else {
+      solution.second->set_input(path);
+    }
   } catch (std::runtime_error& e) {
     xlog::error("day {} could not load: {}\n", solution.second->day(), e.what());
     return {};
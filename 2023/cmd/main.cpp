@@ -1,12 +1,22 @@
 #include "xmaslib/log/log.hpp"
+#include "xmaslib/solution/solution.hpp"
 
+#include "answers.hpp"
 #include "app.hpp"
 #include "cmd.hpp"
+#include "memory.hpp"
+#include "perf.hpp"
+#include "serve.hpp"
 
+#include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 int main(int argc, char** argv) {
@@ -31,6 +41,106 @@ int main(int argc, char** argv) {
     },
   });
 
+  a.register_command({
+    .flags = {"-m", "--memory"},
+    .help = "Track the heap usage of every part of the solutions run by the following commands.\n"
+            "Optionally, a budget in MiB can be specified: days whose peak usage exceeds it fail.",
+    .run =
+      [](app::app&, app::argv args) {
+        if (args.size() > 1) {
+          xlog::error("--memory takes at most one argument");
+          return exit_bad_args;
+        }
+
+        std::optional<std::uint64_t> budget;
+        if (args.size() == 1) {
+          std::uint64_t mib = 0;
+          auto [ptr, ec] = std::from_chars(args[0].begin(), args[0].end(), mib);
+          if (ec != std::errc{} || ptr != args[0].end()) {
+            xlog::error("Value {} is not a valid memory budget", args[0]);
+            return exit_bad_args;
+          }
+          budget = mib << 20;
+        }
+
+        app::memory::enable(budget);
+        return exit_success;
+      },
+  });
+
+  a.register_command({
+    .flags = {"-p", "--perf"},
+    .help = "Read hardware performance counters during the --time command that follows.\n"
+            "If they are not available, only time is reported.",
+    .run =
+      [](app::app&, app::argv args) {
+        if (args.size() != 0) {
+          xlog::error("--perf takes no arguments");
+          return exit_bad_args;
+        }
+
+        app::perf::enable();
+        return exit_success;
+      },
+  });
+
+  a.register_command({
+    .flags = {"-c", "--cache"},
+    .help = "Store the parsed inputs of the solutions run by the following commands next to the\n"
+            "inputs, and load them from there when the inputs have not changed.",
+    .run =
+      [](app::app&, app::argv args) {
+        if (args.size() != 0) {
+          xlog::error("--cache takes no arguments");
+          return exit_bad_args;
+        }
+
+        xmas::solution::enable_input_cache(true);
+        return exit_success;
+      },
+  });
+
+  a.register_command({
+    .flags = {"-M", "--memoize"},
+    .help = "Reuse the answers of earlier runs of the following --run or --all commands, when\n"
+            "neither the input nor the binary changed. Optionally, a fraction of the days to\n"
+            "solve anyway can be specified, to verify that their memoized answers are right.",
+    .run =
+      [](app::app&, app::argv args) {
+        if (args.size() > 1) {
+          xlog::error("--memoize takes at most one argument");
+          return exit_bad_args;
+        }
+
+        double fraction = 0;
+        if (args.size() == 1) {
+          auto [ptr, ec] = std::from_chars(args[0].begin(), args[0].end(), fraction);
+          if (ec != std::errc{} || ptr != args[0].end() || fraction < 0 || fraction > 1) {
+            xlog::error("Value {} is not a valid fraction", args[0]);
+            return exit_bad_args;
+          }
+        }
+
+        app::answers::enable(fraction, false);
+        return exit_success;
+      },
+  });
+
+  a.register_command({
+    .flags = {"-f", "--refresh"},
+    .help = "Like --memoize, but solve every day anyway and replace its memoized answers",
+    .run =
+      [](app::app&, app::argv args) {
+        if (args.size() != 0) {
+          xlog::error("--refresh takes no arguments");
+          return exit_bad_args;
+        }
+
+        app::answers::enable(0, true);
+        return exit_success;
+      },
+  });
+
   a.register_command({
     .flags = {"-r", "--run"},
     .help = "Run the solutions for the specified days",
@@ -99,5 +209,32 @@ int main(int argc, char** argv) {
       },
   });
 
+  a.register_command({
+    .flags = {"-s", "--serve"},
+    .help = "Answer solve requests sent to the Unix socket at the given path until interrupted.\n"
+            "Optionally, the number of worker threads can be specified (default: one per core).",
+    .run =
+      [](app::app&, app::argv args) {
+        if (args.size() < 1 || args.size() > 2) {
+          xlog::error("--serve takes a socket path and optionally a number of threads");
+          return exit_bad_args;
+        }
+
+        std::size_t nthreads = std::max(1u, std::thread::hardware_concurrency());
+        if (args.size() == 2) {
+          auto [ptr, ec] = std::from_chars(args[1].begin(), args[1].end(), nthreads);
+          if (ec != std::errc{} || ptr != args[1].end() || nthreads == 0) {
+            xlog::error("Value {} is not a valid number of threads", args[1]);
+            return exit_bad_args;
+          }
+        }
+
+        if (!app::serve::run(std::string(args[0]), nthreads)) {
+          return exit_failure;
+        }
+        return exit_success;
+      },
+  });
+
   return a.run(args);
 }
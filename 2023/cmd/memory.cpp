@@ -0,0 +1,243 @@
+#include "memory.hpp"
+
+#include "xmaslib/log/log.hpp"
+#include "xmaslib/solution/solution.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <malloc.h>
+
+namespace {
+
+std::atomic<bool> tracking{false};
+
+std::atomic<std::uint64_t> allocations{0};
+std::atomic<std::uint64_t> allocated_bytes{0};
+
+// Live bytes allocated since tracking began. Memory allocated before then and freed
+// afterwards can bring it below zero, so only differences are meaningful.
+std::atomic<std::int64_t> live_bytes{0};
+std::atomic<std::int64_t> peak_live_bytes{0};
+
+// Written only between parts
+std::optional<std::uint64_t> budget;
+std::int64_t part_baseline = 0;
+std::array<app::memory::usage, 2> last{};
+
+// Blocks are accounted for by their usable size rather than the requested one, so that
+// unsized deletes can be accounted for without storing the size next to every block.
+void on_allocate(void* p) noexcept {
+  if (!tracking.load(std::memory_order_relaxed) || p == nullptr) {
+    return;
+  }
+
+  const auto size = ::malloc_usable_size(p);
+  const auto ssize = static_cast<std::int64_t>(size);
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+  const auto live = live_bytes.fetch_add(ssize, std::memory_order_relaxed) + ssize;
+  auto peak = peak_live_bytes.load(std::memory_order_relaxed);
+  while (live > peak &&
+         !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void on_deallocate(void* p) noexcept {
+  if (!tracking.load(std::memory_order_relaxed) || p == nullptr) {
+    return;
+  }
+  const auto size = ::malloc_usable_size(p);
+  live_bytes.fetch_sub(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+}
+
+constexpr std::size_t default_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+void* allocate(std::size_t size, std::size_t alignment) noexcept {
+  // malloc(0) may return null, which operator new must not
+  size = std::max(size, std::size_t{1});
+
+  void* p = nullptr;
+  if (alignment <= default_alignment) {
+    p = std::malloc(size);
+  } else {
+    p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+  }
+
+  on_allocate(p);
+  return p;
+}
+
+void* allocate_or_throw(std::size_t size, std::size_t alignment) {
+  while (true) {
+    if (void* p = allocate(size, alignment); p != nullptr) {
+      return p;
+    }
+    auto handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc{};
+    }
+    handler();
+  }
+}
+
+void deallocate(void* p) noexcept {
+  on_deallocate(p);
+  std::free(p);
+}
+
+void begin_part(int, int part) {
+  // If the part throws, end_part is not called, and the usage of the previous run must not
+  // be reported in its place
+  last[static_cast<std::size_t>(part - 1)] = {};
+
+  allocations.store(0, std::memory_order_relaxed);
+  allocated_bytes.store(0, std::memory_order_relaxed);
+  part_baseline = live_bytes.load(std::memory_order_relaxed);
+  peak_live_bytes.store(part_baseline, std::memory_order_relaxed);
+}
+
+void end_part(int, int part) {
+  last[static_cast<std::size_t>(part - 1)] = {
+    .allocations = allocations.load(std::memory_order_relaxed),
+    .bytes = allocated_bytes.load(std::memory_order_relaxed),
+    .peak_bytes =
+      static_cast<std::uint64_t>(peak_live_bytes.load(std::memory_order_relaxed) - part_baseline),
+  };
+}
+
+constexpr std::uint64_t kib(std::uint64_t bytes) {
+  return bytes / 1024;
+}
+
+} // namespace
+
+namespace app::memory {
+
+void enable(std::optional<std::uint64_t> budget_bytes) {
+  budget = budget_bytes;
+  tracking.store(true, std::memory_order_relaxed);
+  xmas::solution::set_part_hooks({.before = begin_part, .after = end_part});
+}
+
+bool enabled() noexcept {
+  return tracking.load(std::memory_order_relaxed);
+}
+
+std::array<usage, 2> last_run() noexcept {
+  return last;
+}
+
+bool check_budget(int day, int part, std::uint64_t peak_bytes) {
+  if (!budget.has_value() || peak_bytes <= *budget) {
+    return true;
+  }
+
+  xlog::error("Day {} part {} peaked at {} KiB, over the budget of {} KiB", day, part,
+    kib(peak_bytes), kib(*budget));
+  return false;
+}
+
+bool report(int day) {
+  if (!enabled()) {
+    return true;
+  }
+
+  bool success = true;
+  for (int part = 1; part <= 2; ++part) {
+    auto const& u = last[static_cast<std::size_t>(part - 1)];
+    xlog::info("Memory {}: {} allocations, {} KiB allocated, {} KiB peak", part, u.allocations,
+      kib(u.bytes), kib(u.peak_bytes));
+    success = check_budget(day, part, u.peak_bytes) && success;
+  }
+  return success;
+}
+
+} // namespace app::memory
+
+// Replacements for the global allocation functions. They are always in place, but until
+// tracking is enabled they only add the check of a relaxed atomic flag to malloc and free.
+
+void* operator new(std::size_t size) {
+  return allocate_or_throw(size, default_alignment);
+}
+
+void* operator new[](std::size_t size) {
+  return allocate_or_throw(size, default_alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept {
+  return allocate(size, default_alignment);
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept {
+  return allocate(size, default_alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept {
+  return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept {
+  return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void* p) noexcept {
+  deallocate(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+  deallocate(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+  deallocate(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+  deallocate(p);
+}
+
+void operator delete(void* p, std::nothrow_t const&) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void* p, std::nothrow_t const&) noexcept {
+  deallocate(p);
+}
+
+void operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept {
+  deallocate(p);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+// memory tracks the heap usage of every part of every solution. The global operator new
+// and delete of the aoc2023 binary are replaced so that, once tracking is enabled, every
+// allocation is attributed to the part running at the time, regardless of the thread
+// that made it.
+namespace app::memory {
+
+// Bytes are counted by the usable size of the blocks, which malloc may round up from the
+// size requested
+struct usage {
+  std::uint64_t allocations = 0;
+  std::uint64_t bytes = 0;      // Total allocated, including memory that was freed later
+  std::uint64_t peak_bytes = 0; // Maximum live memory above what was live when the part began
+};
+
+// Starts attributing allocations to parts. Days whose peak exceeds the budget fail.
+void enable(std::optional<std::uint64_t> budget_bytes);
+[[nodiscard]] bool enabled() noexcept;
+
+// The usage of each part (indexed by part-1) during the last run
+[[nodiscard]] std::array<usage, 2> last_run() noexcept;
+
+// Returns false (and logs why) if a part peaked above the budget
+bool check_budget(int day, int part, std::uint64_t peak_bytes);
+
+// Logs the usage of the last run of a day, and returns false if it exceeded the budget
+bool report(int day);
+
+} // namespace app::memory
@@ -0,0 +1,247 @@
+#include "perf.hpp"
+
+#include "xmaslib/log/log.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <tbb/task_scheduler_observer.h>
+#endif
+
+namespace app::perf {
+
+sample& sample::operator+=(sample const& other) {
+  for (std::size_t e = 0; e < n_events; ++e) {
+    if (counts[e].has_value() && other.counts[e].has_value()) {
+      *counts[e] += *other.counts[e];
+    } else {
+      counts[e].reset();
+    }
+  }
+  return *this;
+}
+
+std::optional<double> sample::ipc() const {
+  if (!counts[cycles].has_value() || !counts[instructions].has_value() || *counts[cycles] == 0) {
+    return {};
+  }
+  return static_cast<double>(*counts[instructions]) / static_cast<double>(*counts[cycles]);
+}
+
+std::optional<double> sample::mpki(event e) const {
+  if (!counts[e].has_value() || !counts[instructions].has_value() ||
+      *counts[instructions] == 0) {
+    return {};
+  }
+  return 1000.0 * static_cast<double>(*counts[e]) / static_cast<double>(*counts[instructions]);
+}
+
+#ifdef __linux__
+
+namespace {
+
+struct thread_counters {
+  std::array<int, n_events> fds;
+};
+
+std::mutex mutex;
+std::vector<thread_counters> threads;
+std::array<bool, n_events> available{};
+bool is_enabled = false;
+
+perf_event_attr attributes(event e) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.disabled = 1;
+  attr.exclude_kernel = 1; // Allowed with the default perf_event_paranoid
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  constexpr auto cache_read_miss = [](std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  };
+
+  switch (e) {
+  case cycles:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case instructions:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    break;
+  case l1d_misses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = cache_read_miss(PERF_COUNT_HW_CACHE_L1D);
+    break;
+  case llc_misses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = cache_read_miss(PERF_COUNT_HW_CACHE_LL);
+    break;
+  case branch_misses:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+    break;
+  case n_events:
+    break;
+  }
+
+  return attr;
+}
+
+// Opens a counter for the calling thread, on any CPU
+int open_counter(event e) {
+  auto attr = attributes(e);
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+void register_this_thread() {
+  thread_counters t;
+  for (std::size_t e = 0; e < n_events; ++e) {
+    t.fds[e] = available[e] ? open_counter(event(e)) : -1;
+  }
+
+  std::scoped_lock lock(mutex);
+  threads.push_back(t);
+}
+
+// Counters only count the thread that opened them, so every worker opens its own
+class worker_observer : public tbb::task_scheduler_observer {
+public:
+  worker_observer() {
+    observe(true);
+  }
+
+  ~worker_observer() {
+    observe(false);
+  }
+
+  void on_scheduler_entry(bool is_worker) override {
+    thread_local bool registered = false;
+    if (is_worker && !registered) {
+      registered = true;
+      register_this_thread();
+    }
+  }
+};
+
+// Reads a counter, scaling it up if the kernel had to multiplex it
+std::uint64_t read_counter(int fd) {
+  struct {
+    std::uint64_t value;
+    std::uint64_t time_enabled;
+    std::uint64_t time_running;
+  } data{};
+
+  if (read(fd, &data, sizeof(data)) != sizeof(data) || data.time_running == 0) {
+    return 0;
+  }
+
+  if (data.time_running == data.time_enabled) {
+    return data.value;
+  }
+
+  return static_cast<std::uint64_t>(static_cast<double>(data.value) *
+                                    static_cast<double>(data.time_enabled) /
+                                    static_cast<double>(data.time_running));
+}
+
+} // namespace
+
+bool enable() {
+  if (is_enabled) {
+    return true;
+  }
+
+  bool any = false;
+  for (std::size_t e = 0; e < n_events; ++e) {
+    const int fd = open_counter(event(e));
+    if (fd < 0) {
+      xlog::warning("Counter for {} is not available: {}", event_names[e], std::strerror(errno));
+      continue;
+    }
+    close(fd);
+    available[e] = true;
+    any = true;
+  }
+
+  if (!any) {
+    xlog::warning("No performance counters are available: only time will be reported");
+    return false;
+  }
+
+  register_this_thread();
+  static worker_observer observer;
+
+  is_enabled = true;
+  return true;
+}
+
+bool enabled() noexcept {
+  return is_enabled;
+}
+
+void start() {
+  std::scoped_lock lock(mutex);
+  for (auto const& t : threads) {
+    for (int fd : t.fds) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+  }
+}
+
+sample stop() {
+  std::scoped_lock lock(mutex);
+
+  sample s;
+  for (std::size_t e = 0; e < n_events; ++e) {
+    if (available[e]) {
+      s.counts[e] = 0;
+    }
+  }
+
+  for (auto const& t : threads) {
+    for (std::size_t e = 0; e < n_events; ++e) {
+      if (t.fds[e] < 0) {
+        continue;
+      }
+      ioctl(t.fds[e], PERF_EVENT_IOC_DISABLE, 0);
+      *s.counts[e] += read_counter(t.fds[e]);
+    }
+  }
+
+  return s;
+}
+
+#else
+
+bool enable() {
+  xlog::warning("Performance counters are only supported on Linux: only time will be reported");
+  return false;
+}
+
+bool enabled() noexcept {
+  return false;
+}
+
+void start() {
+}
+
+sample stop() {
+  return {};
+}
+
+#endif
+
+} // namespace app::perf
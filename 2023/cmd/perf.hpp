@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// perf reads hardware performance counters around solution runs, using perf_event_open.
+// Counters are opened for the calling thread and for every worker thread that joins the
+// TBB arena afterwards, so that parallel solutions are fully accounted for.
+namespace app::perf {
+
+enum event : std::size_t {
+  cycles,
+  instructions,
+  l1d_misses,
+  llc_misses,
+  branch_misses,
+  n_events,
+};
+
+constexpr std::array<std::string_view, n_events> event_names{
+  "cycles", "instructions", "L1D read misses", "LLC read misses", "branch misses"};
+
+struct sample {
+  std::array<std::optional<std::uint64_t>, n_events> counts; // Empty if unavailable
+
+  sample& operator+=(sample const& other);
+
+  // Instructions per cycle
+  [[nodiscard]] std::optional<double> ipc() const;
+
+  // Events per thousand instructions
+  [[nodiscard]] std::optional<double> mpki(event e) const;
+};
+
+// Opens the counters. Those that are not available (e.g. because perf is not permitted)
+// are skipped with a warning. Returns false if none of them could be opened.
+bool enable();
+[[nodiscard]] bool enabled() noexcept;
+
+// Resets and starts the counters of all threads
+void start();
+
+// Stops the counters of all threads and adds them up
+[[nodiscard]] sample stop();
+
+} // namespace app::perf
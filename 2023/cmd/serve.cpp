@@ -0,0 +1,414 @@
+#include "serve.hpp"
+
+#include "solvelib/alldays.hpp"
+#include "xmaslib/log/log.hpp"
+#include "xmaslib/registry/registry.hpp"
+#include "xmaslib/solution/solution.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <execution>
+#include <format>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace app::serve {
+
+namespace {
+
+volatile std::sig_atomic_t stop_requested = 0;
+
+extern "C" void request_stop(int) {
+  stop_requested = 1;
+}
+
+// How often blocking calls wake up to check if the server is stopping
+constexpr int poll_timeout_ms = 200;
+
+// Larger inline inputs are rejected rather than allocated
+constexpr std::size_t max_inline_bytes = std::size_t{64} << 20;
+
+// Longer request lines are rejected, and the connection closed, rather than buffered
+constexpr std::size_t max_line_bytes = std::size_t{16} << 10;
+
+// Waits until fd is readable. Returns false if the server is stopping.
+bool wait_readable(int fd) {
+  pollfd p{.fd = fd, .events = POLLIN, .revents = 0};
+  while (stop_requested == 0) {
+    const int n = ::poll(&p, 1, poll_timeout_ms);
+    if (n > 0) {
+      return true;
+    }
+    if (n < 0 && errno != EINTR) {
+      return false;
+    }
+  }
+  return false;
+}
+
+// connection reads requests from a client socket and writes the responses to it
+class connection {
+public:
+  explicit connection(int fd) : fd(fd) {
+  }
+
+  connection(connection const&) = delete;
+  connection& operator=(connection const&) = delete;
+
+  ~connection() {
+    ::close(fd);
+  }
+
+  // The next line, without the line break. Empty once the client is gone, or if the line is
+  // longer than max_line_bytes.
+  std::optional<std::string> read_line() {
+    while (true) {
+      if (auto eol = buffer.find('\n', pos); eol != std::string::npos) {
+        std::string line = buffer.substr(pos, eol - pos);
+        pos = eol + 1;
+        return line;
+      }
+      if (buffer.size() - pos > max_line_bytes) {
+        too_long = true;
+        return {};
+      }
+      if (!fill()) {
+        return {};
+      }
+    }
+  }
+
+  // Whether the last read_line failed because the line was too long
+  [[nodiscard]] bool line_too_long() const noexcept {
+    return too_long;
+  }
+
+  // The next n bytes. Empty if the client leaves before sending them all.
+  std::optional<std::string> read_bytes(std::size_t n) {
+    while (buffer.size() - pos < n) {
+      if (!fill()) {
+        return {};
+      }
+    }
+    std::string bytes = buffer.substr(pos, n);
+    pos += n;
+    return bytes;
+  }
+
+  bool write(std::string_view data) {
+    while (!data.empty()) {
+      const auto n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        return false;
+      }
+      data.remove_prefix(static_cast<std::size_t>(n));
+    }
+    return true;
+  }
+
+private:
+  bool fill() {
+    // Consumed bytes are dropped before reading more
+    buffer.erase(0, pos);
+    pos = 0;
+
+    if (!wait_readable(fd)) {
+      return false;
+    }
+
+    std::array<char, 1 << 16> chunk;
+    ssize_t n = 0;
+    do {
+      n = ::recv(fd, chunk.data(), chunk.size(), 0);
+    } while (n < 0 && errno == EINTR);
+
+    if (n <= 0) {
+      return false;
+    }
+    buffer.append(chunk.data(), static_cast<std::size_t>(n));
+    return true;
+  }
+
+  int fd;
+  std::string buffer;
+  std::size_t pos = 0;
+  bool too_long = false;
+};
+
+// Connections accepted but not yet picked up by a worker
+class connection_queue {
+public:
+  void push(int fd) {
+    {
+      std::lock_guard lock(mutex);
+      fds.push_back(fd);
+    }
+    cv.notify_one();
+  }
+
+  // The next connection, or nothing once the queue is closed
+  std::optional<int> pop() {
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [this] { return closed || !fds.empty(); });
+    if (fds.empty()) {
+      return {};
+    }
+    const int fd = fds.front();
+    fds.pop_front();
+    return fd;
+  }
+
+  // Wakes up all workers. Connections that were not picked up are dropped.
+  void close() {
+    {
+      std::lock_guard lock(mutex);
+      closed = true;
+      for (int fd : fds) {
+        ::close(fd);
+      }
+      fds.clear();
+    }
+    cv.notify_all();
+  }
+
+private:
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<int> fds;
+  bool closed = false;
+};
+
+// Splits the first word off sv
+std::string_view next_word(std::string_view& sv) {
+  const auto begin = std::min(sv.find_first_not_of(' '), sv.size());
+  sv.remove_prefix(begin);
+  const auto end = std::min(sv.find(' '), sv.size());
+  const auto word = sv.substr(0, end);
+  sv.remove_prefix(end);
+  return word;
+}
+
+std::string_view trim_left(std::string_view sv) {
+  sv.remove_prefix(std::min(sv.find_first_not_of(' '), sv.size()));
+  return sv;
+}
+
+template <typename T>
+std::optional<T> parse_number(std::string_view word) {
+  T value{};
+  auto [ptr, ec] = std::from_chars(word.data(), word.data() + word.size(), value);
+  if (ec != std::errc{} || ptr != word.data() + word.size()) {
+    return {};
+  }
+  return value;
+}
+
+std::int64_t microseconds(xmas::solution::duration d) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+// worker owns an instance of every solution, which it reuses for all the requests it serves
+class worker {
+public:
+  worker() {
+    for (auto const& [day, _] : xmas::registered_solutions()) {
+      solutions[day] = xmas::make_solution(day);
+    }
+  }
+
+  void serve(connection& conn) {
+    while (auto line = conn.read_line()) {
+      if (!conn.write(respond(conn, *line))) {
+        return;
+      }
+    }
+
+    // The rest of the line cannot be told apart from the next request, so the client is dropped
+    if (conn.line_too_long()) {
+      (void)conn.write("error request too long\n");
+    }
+  }
+
+private:
+  std::string respond(connection& conn, std::string_view request) {
+    const auto verb = next_word(request);
+    const auto day = parse_number<int>(next_word(request));
+
+    // The path is the rest of the line, so that it may contain spaces
+    const auto arg = verb == "solve" ? trim_left(request) : next_word(request);
+
+    if (verb != "solve" && verb != "inline") {
+      return std::format("error unknown request '{}'\n", verb);
+    }
+
+    std::optional<std::string> text;
+    if (verb == "inline") {
+      const auto nbytes = parse_number<std::size_t>(arg);
+      if (!nbytes.has_value() || *nbytes > max_inline_bytes) {
+        return std::format("error invalid input size '{}'\n", arg);
+      }
+      // The payload is read even if the day is wrong, so that the next request is found
+      text = conn.read_bytes(*nbytes);
+      if (!text.has_value()) {
+        return "error incomplete input\n";
+      }
+    } else if (arg.empty()) {
+      return "error missing input path\n";
+    }
+
+    if (!day.has_value()) {
+      return "error invalid day\n";
+    }
+
+    auto it = solutions.find(*day);
+    if (it == solutions.end()) {
+      return std::format("error no solution registered for day {}\n", *day);
+    }
+
+    auto& s = *it->second;
+    if (text.has_value()) {
+      s.set_input_text(std::move(*text));
+    } else {
+      s.set_input(arg);
+    }
+
+    if (!s.run(false) && !s.answer(1).has_value() && !s.answer(2).has_value()) {
+      return std::format("error day {} failed, see the server log\n", *day);
+    }
+
+    std::string response;
+    for (int part : {1, 2}) {
+      if (auto answer = s.answer(part); answer.has_value()) {
+        response +=
+          std::format("part {} {} {}\n", part, *answer, microseconds(s.part_time(part)));
+      } else {
+        response += std::format("part {} failed\n", part);
+      }
+    }
+    response += std::format("done {}\n", microseconds(s.time()));
+    return response;
+  }
+
+  std::map<int, std::unique_ptr<xmas::solution>> solutions;
+};
+
+int listen_on(std::string const& path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    xlog::error("socket path {} is too long", path);
+    return -1;
+  }
+  std::ranges::copy(path, addr.sun_path);
+
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    xlog::error("could not create a socket: {}", std::strerror(errno));
+    return -1;
+  }
+
+  // A socket left behind by a previous server would make bind fail
+  ::unlink(path.c_str());
+
+  if (::bind(fd, reinterpret_cast<sockaddr const*>(&addr), sizeof(addr)) != 0
+      || ::listen(fd, SOMAXCONN) != 0) {
+    xlog::error("could not listen on {}: {}", path, std::strerror(errno));
+    ::close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+// Starts the threads of the parallel algorithms, so that the first request does not pay for it
+void warm_up_thread_pool() {
+  std::vector<int> v(std::size_t{1} << 16, 1);
+  const auto sum = std::reduce(std::execution::par, v.begin(), v.end());
+  xlog::debug("thread pool warmed up ({})", sum);
+}
+
+} // namespace
+
+bool run(std::string const& socket_path, std::size_t nthreads) {
+  try {
+    populate_registry();
+  } catch (std::runtime_error& e) {
+    xlog::error("could not populate the registry fully: {}", e.what());
+  }
+
+  const int listener = listen_on(socket_path);
+  if (listener < 0) {
+    return false;
+  }
+
+  struct sigaction action{};
+  action.sa_handler = request_stop;
+  ::sigemptyset(&action.sa_mask);
+  ::sigaction(SIGINT, &action, nullptr);
+  ::sigaction(SIGTERM, &action, nullptr);
+
+  warm_up_thread_pool();
+
+  connection_queue queue;
+  std::vector<std::thread> workers;
+  workers.reserve(nthreads);
+  for (std::size_t i = 0; i < nthreads; ++i) {
+    workers.emplace_back([&queue] {
+      worker w;
+      while (auto fd = queue.pop()) {
+        connection conn(*fd);
+        w.serve(conn);
+      }
+    });
+  }
+
+  xlog::info("Serving on {} with {} threads", socket_path, nthreads);
+
+  while (wait_readable(listener)) {
+    const int fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno != EINTR && errno != ECONNABORTED) {
+        xlog::warning("could not accept a connection: {}", std::strerror(errno));
+      }
+      continue;
+    }
+    queue.push(fd);
+  }
+
+  xlog::info("Shutting down");
+  queue.close();
+  for (auto& t : workers) {
+    t.join();
+  }
+
+  ::close(listener);
+  ::unlink(socket_path.c_str());
+  return true;
+}
+
+} // namespace app::serve
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// serve answers solve requests sent over a Unix domain socket, so that clients that solve
+// many inputs do not pay for starting the binary every time. The registry is populated and
+// the thread pool spun up once, and every worker thread owns its own instance of every
+// solution.
+//
+// Requests are lines of text, and a connection may send any number of them:
+//
+//   solve <day> <path>       Solves the input in the file at path, which is the rest of the
+//                            line and may contain spaces
+//   inline <day> <nbytes>    Solves the nbytes that follow the line
+//
+// Request lines longer than 16 KiB are answered with "error request too long", and the
+// connection is closed.
+//
+// Every request is answered as soon as it is solved, in the order they were received:
+//
+//   part <1|2> <answer> <μs>   For every part that succeeded
+//   part <1|2> failed          For every part that failed
+//   done <μs>                  Total time of both parts
+//   error <message>            Instead of the above, if no part could be run
+namespace app::serve {
+
+// Serves requests with the given number of worker threads until SIGINT or SIGTERM is
+// received. Returns false if the socket could not be set up.
+bool run(std::string const& socket_path, std::size_t nthreads);
+
+} // namespace app::serve
@@ -1,87 +1,154 @@
 #include "day01.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
 #include <format>
-#include <iterator>
 #include <numeric>
-#include <sstream>
-#include <utility>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace {
 
 bool is_num(char ch) {
   return ch >= '0' && ch <= '9';
 }
 
-std::uint64_t Day01::part1() {
-  std::stringstream ss(this->input);
-
-  return std::transform_reduce(std::istream_iterator<std::string>(ss),
-    std::istream_iterator<std::string>{}, 0u, std::plus{},
-    [](std::string_view line) -> std::uint64_t {
-      // First digit
-      const auto first = std::ranges::find_if(line, is_num);
-      if (first == line.end()) {
-        throw std::runtime_error(std::format("line {} contains no numbers", line));
-      }
+constexpr std::array<std::string_view, 10> spelled_digits{
+  "", "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"};
 
-      // Last digit
-      const auto last = std::find_if(line.rbegin(), std::reverse_iterator(first), is_num);
+// Spelled digits indexed by their first letter. No letter starts more than two of them,
+// so at most two comparisons are needed at every position.
+constexpr auto spelled_by_initial = [] {
+  std::array<std::array<std::uint8_t, 2>, 26> table{};
+  for (std::uint8_t d = 1; d < 10; ++d) {
+    auto& slot = table[static_cast<std::size_t>(spelled_digits[d].front() - 'a')];
+    slot[slot[0] == 0 ? 0 : 1] = d;
+  }
+  return table;
+}();
+
+// digit_at returns the value of the digit the text starts with, or -1 if there is none.
+// A literal '0' is a digit, even though no spelled out digit is zero.
+template <bool spelled_out>
+int digit_at(std::string_view text) {
+  const char ch = text.front();
+  if (is_num(ch)) {
+    return ch - '0';
+  }
 
-      // compute
-      return static_cast<std::uint64_t>(int(*first - '0') * 10 + int(*last - '0'));
-    });
-}
+  if constexpr (spelled_out) {
+    if (ch < 'a' || ch > 'z') {
+      return -1;
+    }
+    for (auto d : spelled_by_initial[static_cast<std::size_t>(ch - 'a')]) {
+      if (d != 0 && text.starts_with(spelled_digits[d])) {
+        return d;
+      }
+    }
+  }
 
-template <typename Iterator>
-std::pair<Iterator, int> find_number(Iterator begin, Iterator end) {
-  constexpr static std::array numbers{
-    "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"};
+  return -1;
+}
 
-  if (begin == end) {
-    return std::make_pair(end, 0);
+// calibration_value finds the first digit scanning forward and the last digit scanning
+// backward, so every character is inspected at most once.
+template <bool spelled_out>
+std::optional<std::uint64_t> calibration_value(std::string_view line) {
+  std::size_t i = 0;
+  int first = -1;
+  for (; i < line.size() && first < 0; ++i) {
+    first = digit_at<spelled_out>(line.substr(i));
   }
 
-  auto inc = 1;
-  Iterator endtext = end;
-  if (begin > end) {
-    // reverse
-    inc = -1;
-    endtext = begin;
+  if (first < 0) {
+    return {};
   }
 
-  for (Iterator it = begin; it != end; it += inc) {
-    if (is_num(*it)) {
-      return std::make_pair(it, int(*it - '0'));
-    }
+  int last = -1;
+  for (std::size_t j = line.size(); j >= i && last < 0; --j) {
+    last = digit_at<spelled_out>(line.substr(j - 1));
+  }
 
-    std::string_view window(it, endtext);
+  return static_cast<std::uint64_t>(10 * first + last);
+}
 
-    auto r =
-      std::ranges::find_if(numbers, [window](auto number) { return window.starts_with(number); });
-    if (r == numbers.end()) {
+struct chunk_result {
+  std::uint64_t sum = 0;
+  std::string_view bad_line{}; // First line with no digits, if any
+  bool ok = true;
+};
+
+template <bool spelled_out>
+chunk_result solve_chunk(std::string_view chunk) {
+  chunk_result r;
+  while (!chunk.empty()) {
+    auto endl = std::find(std::execution::unseq, chunk.begin(), chunk.end(), '\n');
+    std::string_view line(chunk.begin(), endl);
+    chunk.remove_prefix(std::min(line.size() + 1, chunk.size()));
+
+    if (line.empty()) {
       continue;
     }
 
-    return std::make_pair(it, r - numbers.begin() + 1);
+    auto value = calibration_value<spelled_out>(line);
+    if (!value.has_value()) {
+      return {.sum = r.sum, .bad_line = line, .ok = false};
+    }
+    r.sum += *value;
+  }
+  return r;
+}
+
+// line_chunks splits the input into pieces of roughly chunk_size bytes that start and end
+// at line boundaries, so that they can be solved independently.
+std::vector<std::string_view> line_chunks(std::string_view input, std::size_t chunk_size) {
+  std::vector<std::string_view> chunks;
+  chunks.reserve(input.size() / chunk_size + 1);
+
+  while (!input.empty()) {
+    auto endl = input.find('\n', std::min(chunk_size, input.size()) - 1);
+    auto len = endl == std::string_view::npos ? input.size() : endl + 1;
+    chunks.push_back(input.substr(0, len));
+    input.remove_prefix(len);
   }
 
-  return std::make_pair(end, 0);
+  return chunks;
+}
+
+template <bool spelled_out>
+std::uint64_t solve(std::string_view input) {
+  constexpr std::size_t chunk_size = 1 << 16;
+  const auto chunks = line_chunks(input, chunk_size);
+
+  auto result = std::transform_reduce(std::execution::par, chunks.begin(), chunks.end(),
+    chunk_result{},
+    [](chunk_result const& l, chunk_result const& r) -> chunk_result {
+      return {
+        .sum = l.sum + r.sum,
+        .bad_line = l.ok ? r.bad_line : l.bad_line,
+        .ok = l.ok && r.ok,
+      };
+    },
+    solve_chunk<spelled_out>);
+
+  if (!result.ok) {
+    throw std::runtime_error(std::format("line {} contains no numbers", result.bad_line));
+  }
+
+  return result.sum;
+}
+
+}
+
+std::uint64_t Day01::part1() {
+  return solve<false>(this->input);
 }
 
 std::uint64_t Day01::part2() {
-  std::stringstream ss(this->input);
-
-  return std::transform_reduce(std::istream_iterator<std::string>(ss),
-    std::istream_iterator<std::string>{}, 0u, std::plus<std::uint64_t>{},
-    [](std::string_view line) {
-      // First digit
-      const auto first = find_number(line.begin(), line.end());
-      if (first.first == line.end())
-        throw std::runtime_error(std::format("line {} contains no numbers", line));
-
-      // Last digit
-      const auto last = find_number(line.end(), first.first - 1);
-
-      // compute
-      return first.second * 10 + last.second;
-    });
+  return solve<true>(this->input);
 }
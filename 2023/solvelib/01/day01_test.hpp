@@ -8,6 +8,11 @@ TEST_CASE("Day 1") {
     solution.set_input("./data/01/example1.txt");
     solution.load();
     REQUIRE_EQ(solution.day(), 1);
+
+    // A literal zero is a digit too: 00 + 05 + 70
+    solution.set_input("./data/01/example4.txt");
+    solution.load();
+    REQUIRE_EQ(solution.part1(), 75);
   }
 
   SUBCASE("Part 2") {
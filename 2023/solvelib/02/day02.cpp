@@ -1,48 +1,47 @@
+#include <execution>
+#include <functional>
 #include <numeric>
-#include <string_view>
 
 #include "day02.hpp"
 #include "game.hpp"
-#include "xmaslib/line_iterator/line_iterator.hpp"
-#include "xmaslib/log/log.hpp"
+#include "xmaslib/iota/iota.hpp"
 
-std::uint64_t Day02::part1() {
-  xmas::views::linewise range(this->input);
+void Day02::load() {
+  xmas::solution::load();
+  games.reset();
+}
+
+game_table const& Day02::parsed() {
+  if (!games.has_value()) {
+    games = parse_games(this->input);
+  }
+  return *games;
+}
 
+std::uint64_t Day02::part1() {
   constexpr std::int64_t max_red = 12;
   constexpr std::int64_t max_green = 13;
   constexpr std::int64_t max_blue = 14;
 
-  return std::transform_reduce(
-    range.begin(), range.end(), 0u, std::plus{}, [](std::string_view line) -> std::int64_t {
-      const game g(line);
-
-      if (g.max.red > max_red) {
-        xlog::debug("Rejected because of red: {}", g);
-        return 0;
-      }
-      if (g.max.green > max_green) {
-        xlog::debug("Rejected because of green: {}", g);
-        return 0;
-      }
-      if (g.max.blue > max_blue) {
-        xlog::debug("Rejected because of blue: {}", g);
-        return 0;
-      }
-
-      return g.id;
-    });
+  auto const& g = parsed();
+
+  const auto possible = [&g](std::size_t i) -> bool {
+    return g.red[i] <= max_red && g.green[i] <= max_green && g.blue[i] <= max_blue;
+  };
+
+  const xmas::views::iota<std::size_t> idx(g.size());
+
+  return static_cast<std::uint64_t>(std::transform_reduce(std::execution::unseq, idx.cbegin(),
+    idx.cend(), std::int64_t{0}, std::plus{},
+    [&](std::size_t i) -> std::int64_t { return possible(i) ? g.id[i] : 0; }));
 }
 
 std::uint64_t Day02::part2() {
-  xmas::views::linewise range(this->input);
+  auto const& g = parsed();
 
-  return std::transform_reduce(
-    range.begin(), range.end(), 0u, std::plus{}, [](std::string_view line) -> std::uint64_t {
-      const game g(line);
+  const xmas::views::iota<std::size_t> idx(g.size());
 
-      const auto p = static_cast<std::uint64_t>(g.max.red * g.max.green * g.max.blue);
-      xlog::debug("Power value is {} for {}", p, g);
-      return p;
-    });
+  return static_cast<std::uint64_t>(std::transform_reduce(std::execution::unseq, idx.cbegin(),
+    idx.cend(), std::int64_t{0}, std::plus{},
+    [&g](std::size_t i) -> std::int64_t { return g.red[i] * g.green[i] * g.blue[i]; }));
 }
@@ -1,14 +1,24 @@
 #pragma once
 
+#include "game.hpp"
 #include "xmaslib/solution/solution.hpp"
 
+#include <optional>
+
 class Day02 : public xmas::solution {
 public:
   int day() override {
     return 2;
   }
 
+  void load() override;
+
 public:
   std::uint64_t part1() override;
   std::uint64_t part2() override;
+
+private:
+  // Both parts reduce over the same games, so they are only parsed once per input
+  std::optional<game_table> games;
+  game_table const& parsed();
 };
@@ -1,97 +1,147 @@
 #include "game.hpp"
 
 #include <algorithm>
-#include <execution>
+#include <charconv>
 #include <format>
 #include <stdexcept>
 
 #include "xmaslib/log/log.hpp"
 
-rgb parse_round(std::string_view data) {
-  rgb round{0, 0, 0};
+namespace {
 
-  auto it = data.begin();
-  while (it != data.end()) {
+// cursor walks the input once. Errors are only formatted once parsing has failed.
+class cursor {
+public:
+  explicit cursor(std::string_view input) : it(input.data()), end(input.data() + input.size()) {
+  }
+
+  [[nodiscard]] bool done() const noexcept {
+    return it == end;
+  }
 
-    // Skip leading whitespace
-    it = std::find_if(it, data.end(), [](auto ch) { return ch != ' '; });
-    if (it == data.end())
-      break;
+  [[nodiscard]] char peek() const noexcept {
+    return it == end ? '\n' : *it;
+  }
+
+  void skip_spaces() noexcept {
+    while (it != end && *it == ' ') {
+      ++it;
+    }
+  }
 
-    // Parse number
-    std::int64_t count;
-    const auto result = std::from_chars(it, data.end(), count, 10);
-    if (result.ptr == data.end()) {
-      throw std::runtime_error(std::format("could not parse dice count in string {}", data));
+  // Skips the expected text, or throws if it is not there
+  void expect(std::string_view text, std::size_t line) {
+    if (std::string_view(it, end).starts_with(text)) {
+      it += text.size();
+      return;
     }
+    fail(line, std::format("expected '{}'", text));
+  }
 
-    // Skip whitespace
-    it = std::find_if(result.ptr, data.end(), [](auto ch) { return ch != ' '; });
-
-    // Parse colour
-    if (it == data.end())
-      throw std::runtime_error(std::format("could not find colour in string {}", data));
-
-    switch (*it) {
-    case 'r':
-      round.red += count;
-      break;
-    case 'g':
-      round.green += count;
-      break;
-    case 'b':
-      round.blue += count;
-      break;
-    default:
-      throw std::runtime_error(
-        std::format("unknown colour in string {} (after digit {})", data, count));
+  std::int64_t number(std::size_t line) {
+    std::int64_t n;
+    const auto result = std::from_chars(it, end, n, 10);
+    if (result.ec != std::errc{}) {
+      fail(line, "expected a number");
     }
+    it = result.ptr;
+    return n;
+  }
 
-    // Advance start of next dice
-    it = std::find(it, data.end(), ',');
-    if (it != data.end()) {
+  // Skips the rest of a word
+  char word() noexcept {
+    const char first = peek();
+    while (it != end && *it >= 'a' && *it <= 'z') {
       ++it;
     }
+    return first;
+  }
+
+  char next() noexcept {
+    return it == end ? '\n' : *it++;
+  }
+
+  [[noreturn]] void fail(std::size_t line, std::string_view what) const {
+    const auto rest = std::string_view(it, std::find(it, end, '\n'));
+    throw std::runtime_error(std::format("line {}: {} at '{}'", line + 1, what, rest));
   }
 
-  return round;
+private:
+  char const* it;
+  char const* end;
+};
+
+} // namespace
+
+void game_table::reserve(std::size_t n) {
+  id.reserve(n);
+  red.reserve(n);
+  green.reserve(n);
+  blue.reserve(n);
 }
 
-game::game(std::string_view line) {
-  // Parse prefix
-  auto space = std::ranges::find(line, ' ');
-  if (space == line.end())
-    throw std::runtime_error(std::format("could not find space in line {}", line));
+void game_table::push_back(game const& g) {
+  id.push_back(g.id);
+  red.push_back(g.max.red);
+  green.push_back(g.max.green);
+  blue.push_back(g.max.blue);
+}
 
-  const auto result = std::from_chars(space + 1, line.end(), this->id, 10);
-  if (result.ptr == line.end()) {
-    throw std::runtime_error(std::format("could not parse game ID in line {}", line));
-  }
+game_table parse_games(std::string_view input) {
+  game_table games;
+  games.reserve(static_cast<std::size_t>(std::ranges::count(input, '\n')) + 1);
 
-  // Parse rounds
-  std::vector<std::string_view::const_iterator> semicolons;
-  std::string_view::const_iterator it = result.ptr + 1; // +1 to ignore the whitespace after :
-  semicolons.push_back(it);
-  while (it != line.end()) {
-    it = std::find(it + 1, line.end(), ';');
-    semicolons.push_back(it);
-  }
+  cursor c(input);
+  for (std::size_t line = 0; !c.done(); ++line) {
+    if (c.peek() == '\n') { // Empty line
+      c.next();
+      continue;
+    }
+
+    c.expect("Game ", line);
+    game g{.id = c.number(line), .max = {}};
+    c.expect(":", line);
 
-  try {
-    this->max = std::transform_reduce(
-      std::execution::par_unseq, semicolons.cbegin(), semicolons.cend() - 1,
-      semicolons.cbegin() + 1, rgb{},
-      [](rgb const& acc, rgb const& round) -> rgb {
-        return rgb{
-          .red = std::max(acc.red, round.red),
-          .green = std::max(acc.green, round.green),
-          .blue = std::max(acc.blue, round.blue),
-        };
-      },
-      [](auto prev, auto next) -> rgb {
-        return parse_round(std::string_view{prev + 1, next});
-      });
-  } catch (std::runtime_error& e) {
-    throw std::runtime_error(std::format("could not parse round in line {}: {}", line, e.what()));
+    rgb round{};
+    for (bool end_of_line = false; !end_of_line;) {
+      c.skip_spaces();
+      const auto count = c.number(line);
+      c.skip_spaces();
+
+      switch (c.word()) {
+      case 'r':
+        round.red += count;
+        break;
+      case 'g':
+        round.green += count;
+        break;
+      case 'b':
+        round.blue += count;
+        break;
+      default:
+        c.fail(line, "unknown colour");
+      }
+
+      switch (c.next()) {
+      case ',':
+        continue;
+      case '\n':
+        end_of_line = true;
+        [[fallthrough]];
+      case ';':
+        g.max.red = std::max(g.max.red, round.red);
+        g.max.green = std::max(g.max.green, round.green);
+        g.max.blue = std::max(g.max.blue, round.blue);
+        round = {};
+        break;
+      default:
+        c.fail(line, "expected a separator");
+      }
+    }
+
+    games.push_back(g);
   }
-}
\ No newline at end of file
+
+  xlog::debug("Parsed {} games", games.size());
+  return games;
+}
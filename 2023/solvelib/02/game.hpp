@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <format>
 #include <string_view>
+#include <vector>
 
 struct rgb {
   std::int64_t red;
@@ -13,10 +15,31 @@ struct rgb {
 struct game {
   std::int64_t id;
   rgb max;
+};
+
+// game_table stores the games column by column, so that reductions over them vectorize
+struct game_table {
+  std::vector<std::int64_t> id;
+  std::vector<std::int64_t> red;
+  std::vector<std::int64_t> green;
+  std::vector<std::int64_t> blue;
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return id.size();
+  }
 
-  explicit game(std::string_view);
+  [[nodiscard]] game operator[](std::size_t i) const noexcept {
+    return {.id = id[i], .max = {.red = red[i], .green = green[i], .blue = blue[i]}};
+  }
+
+  void reserve(std::size_t n);
+  void push_back(game const& g);
 };
 
+// parse_games reads every game in the input with a single forward pass, and stores
+// the maximum number of dice of each colour shown in any of its rounds.
+[[nodiscard]] game_table parse_games(std::string_view input);
+
 template <>
 struct std::formatter<rgb> : std::formatter<std::string> {
   auto format(rgb const& r, format_context& ctx) const {
@@ -32,4 +55,4 @@ struct std::formatter<game> : std::formatter<std::string> {
 
     return formatter<std::string>::format(f, ctx);
   }
-};
\ No newline at end of file
+};
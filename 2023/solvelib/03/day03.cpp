@@ -1,11 +1,13 @@
 #include "day03.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <execution>
-#include <format>
 #include <functional>
 #include <numeric>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -25,221 +27,114 @@ std::pair<std::size_t, std::size_t> dimensions(std::string_view input) {
 
   return std::make_pair(nrows, ncols);
 }
-} // namespace
-
-std::uint64_t Day03::part1() {
-  const auto [nrows, ncols] = dimensions(this->input);
-
-  // Make a mask labeling all symbol-adjacent cells
-  // Cannot use vector<bool> because writing into nearby entries is
-  // thread-unsafe.
-  std::vector<std::int8_t> mask(this->input.size(), 0);
-  {
-    // Detect symbols
-    std::vector<std::int8_t> symbols(this->input.size(), 0);
-    std::transform(std::execution::par_unseq, this->input.cbegin(), this->input.cend(),
-      symbols.begin(), [](char ch) {
-        if (ch == '.')
-          return 0;
-        if (ch == '\n')
-          return 0;
-        if (ch >= '0' && ch <= '9')
-          return 0;
-
-        // Upper row
-        return 1;
-      });
-
-    std::vector<std::size_t> iota(this->input.size(), 0);
-    std::iota(iota.begin(), iota.end(), 0);
-
-    // Expand the mask to cover symbol adjacency
-    std::transform(std::execution::par_unseq, iota.cbegin(), iota.cend(), mask.begin(),
-      [nrows, ncols, &symbols](std::size_t idx) -> std::int64_t {
-        // Top row
-        const auto row = idx / ncols;
-        const auto col = idx % ncols;
-
-        const bool leftmost = (col == 0);
-        const bool rightmost = (col == ncols - 1);
-
-        if (rightmost) {
-          // Skip \n
-          return 0;
-        }
-
-        // Same row
-        if (!leftmost && symbols[idx - 1] == 1)
-          return 1;
-        if (!rightmost && symbols[idx + 1] == 1)
-          return 1;
-
-        // Top row
-        if (row > 0) {
-          const auto top = idx - ncols;
-          if (symbols[top] == 1)
-            return 1;
-          if (!leftmost && symbols[top - 1] == 1)
-            return 1;
-          if (!rightmost && symbols[top + 1] == 1)
-            return 1;
-        }
 
-        // Bottom row
-        if (row < nrows - 1) {
-          const auto bot = idx + ncols;
-          if (symbols[bot] == 1)
-            return 1;
-          if (!leftmost && symbols[bot - 1] == 1)
-            return 1;
-          if (!rightmost && symbols[bot + 1] == 1)
-            return 1;
-        }
-
-        return 0;
-      });
-  }
+constexpr bool issymbol(char ch) {
+  return ch != '.' && ch != '\n' && !isnum(ch);
+}
 
-  // Parse each row
-  std::vector<std::size_t> rows(nrows, 0);
-  std::iota(rows.begin(), rows.end(), 0);
-  return std::transform_reduce(std::execution::par_unseq, rows.begin(), rows.end(), 0u, std::plus{},
-    [ncols, this, &mask](std::size_t row) {
-      auto begin = row * ncols;
-      auto end = begin + ncols;
+// Numbers adjacent to a gear candidate ('*') seen so far
+struct gear {
+  std::uint8_t count = 0;
+  std::uint64_t ratio = 1;
+};
+
+struct schematic {
+  std::uint64_t part_numbers = 0;
+  std::uint64_t gear_ratios = 0;
+};
+
+/*
+scan labels the numbers row by row, and matches them with the symbols around them.
+
+A number only touches the rows above and below its own, so only three rows are
+ever in flight. The gears of each of those rows are tracked in one of three
+rolling buffers. Once the row below a gear has been scanned, all its neighbours
+are known and its ratio is final, so the buffer is reused for the next row.
+*/
+schematic scan(std::string_view input) {
+  const auto [nrows, ncols] = dimensions(input);
+  const std::size_t width = ncols - 1; // Excluding the newline
+
+  const auto row = [&](std::size_t r) -> std::string_view {
+    return input.substr(r * ncols, width);
+  };
+
+  std::array<std::vector<gear>, 3> gears;
+  std::ranges::fill(gears, std::vector<gear>(width));
+
+  const auto finish_gears = [](std::vector<gear> const& row_gears) -> std::uint64_t {
+    return std::transform_reduce(std::execution::unseq, row_gears.cbegin(), row_gears.cend(),
+      std::uint64_t{0}, std::plus{},
+      [](gear const& g) -> std::uint64_t { return g.count == 2 ? g.ratio : 0; });
+  };
+
+  schematic result;
+  for (std::size_t r = 0; r < nrows; ++r) {
+    // The buffer of row r-2 is reused for row r+1
+    std::ranges::fill(gears[(r + 1) % 3], gear{});
+
+    const std::string_view line = row(r);
+    for (std::size_t begin = 0; begin < width;) {
+      if (!isnum(line[begin])) {
+        ++begin;
+        continue;
+      }
 
-      std::uint64_t total = 0;
       std::uint64_t num = 0;
-      bool relevant = false;
-
-      for (std::size_t idx = begin; idx != end; ++idx) {
-        if (!isnum(input[idx])) {
-          if (relevant) {
-            total += num;
-            xlog::debug("Row {}: Adding number {}", row, num);
-          } else if (num != 0) {
-            xlog::debug("Row {}: Ignoring number {}", row, num);
-          }
-          num = 0;
-          relevant = false;
-          continue;
-        }
-
-        // Parse next digit
-        num *= 10;
-        num += uint(input[idx] - '0');
-
-        // Is it in contact?
-        if (mask[idx] == 1)
-          relevant = true;
+      std::size_t end = begin;
+      for (; end < width && isnum(line[end]); ++end) {
+        num = 10 * num + std::uint64_t(line[end] - '0');
       }
 
-      return total;
-    });
-}
-
-std::uint64_t Day03::part2() {
-  const auto [nrows, ncols] = dimensions(this->input);
-
-  std::vector<std::size_t> rows(nrows, 0);
-  std::iota(rows.begin(), rows.end(), 0);
-
-  // Build a matrix where each entry is the number that digit belongs to
-  std::vector numbers(nrows, std::vector(ncols, std::int64_t(-1)));
-  std::for_each(std::execution::par_unseq, rows.begin(), rows.end(),
-    [ncols, this, &numbers](const std::size_t row) {
-      auto row_begin = row * ncols;
-      std::size_t num_begin = 0;
-
-      std::int64_t num = 0;
-
-      for (std::size_t col = 0; col < ncols; ++col) {
-        const auto idx = row_begin + col;
-
-        if (!isnum(input[idx])) {
-          if (col - num_begin != 0) {
-            xlog::debug("Found number {} in row {}, cols [{}, {})", num, row, num_begin, col);
-            std::fill(numbers[row].begin() + std::ptrdiff_t(num_begin),
-              numbers[row].begin() + std::ptrdiff_t(col), num);
+      // Columns touching the number, including diagonals
+      const std::size_t first = begin == 0 ? 0 : begin - 1;
+      const std::size_t last = std::min(end, width - 1);
+
+      bool part = false;
+      for (std::size_t rr = (r == 0 ? 0 : r - 1); rr <= r + 1 && rr < nrows; ++rr) {
+        const std::string_view neighbours = row(rr);
+        auto& row_gears = gears[rr % 3];
+        for (std::size_t c = first; c <= last; ++c) {
+          if (!issymbol(neighbours[c])) {
+            continue;
+          }
+          part = true;
+          if (neighbours[c] == '*') {
+            ++row_gears[c].count;
+            row_gears[c].ratio *= num;
           }
-
-          num = 0;
-          num_begin = col + 1;
-          continue;
         }
-
-        // Parse next digit
-        num *= 10;
-        num += input[idx] - '0';
-      }
-    });
-
-  // Scan for gears
-  std::vector<std::size_t> iota(nrows * ncols, 0);
-  std::iota(iota.begin(), iota.end(), 0);
-  return std::transform_reduce(std::execution::par_unseq, iota.begin(), iota.end(), 0u, std::plus{},
-    [this, nrows, ncols, &numbers](const std::size_t idx) -> std::uint64_t {
-      if (this->input[idx] != '*') {
-        return 0;
       }
 
-      const auto row = idx / ncols;
-      const auto col = idx % ncols;
+      if (part) {
+        xlog::debug("Row {}: Adding number {}", r, num);
+        result.part_numbers += num;
+      } else {
+        xlog::debug("Row {}: Ignoring number {}", r, num);
+      }
 
-      std::vector<std::uint64_t> neighbours;
-      neighbours.reserve(5);
+      begin = end;
+    }
 
-      const bool leftmost = (col == 0);
-      const bool rightmost = (col == ncols - 1);
+    // All neighbours of the gears in the row above are known now
+    if (r > 0) {
+      result.gear_ratios += finish_gears(gears[(r - 1) % 3]);
+    }
+  }
 
-      // Side neighbours
-      if (!leftmost && numbers[row][col - 1] != -1) {
-        neighbours.emplace_back(numbers[row][col - 1]);
-      }
-      if (!rightmost && numbers[row][col + 1] != -1) {
-        neighbours.emplace_back(numbers[row][col + 1]);
-      }
+  if (nrows > 0) {
+    result.gear_ratios += finish_gears(gears[(nrows - 1) % 3]);
+  }
 
-      // Up neighbours
-      if (row != 0) {
-        auto r = numbers[row - 1];
-        if (r[col] != -1) {
-          // Either a number on top
-          neighbours.emplace_back(r[col]);
-        } else {
-          // Or numbers on top-left and top-right
-          if (!leftmost && r[col - 1] != -1) {
-            neighbours.emplace_back(r[col - 1]);
-          }
-          if (!rightmost && r[col + 1] != -1) {
-            neighbours.emplace_back(r[col + 1]);
-          }
-        }
-      }
+  return result;
+}
 
-      // Down neighbours
-      if (row + 1 != nrows) {
-        auto r = numbers[row + 1];
-        if (r[col] != -1) {
-          // Either a number below
-          neighbours.emplace_back(r[col]);
-        } else {
-          // Or numbers below-left and below-right
-          if (!leftmost && r[col - 1] != -1) {
-            neighbours.emplace_back(r[col - 1]);
-          }
-          if (!rightmost && r[col + 1] != -1) {
-            neighbours.emplace_back(r[col + 1]);
-          }
-        }
-      }
+} // namespace
 
-      if (auto sz = neighbours.size(); sz != 2) {
-        xlog::debug("Gear in row {} has {} neighbour{}", row, sz, sz > 1 ? "s" : "");
-        return 0;
-      }
+std::uint64_t Day03::part1() {
+  return scan(this->input).part_numbers;
+}
 
-      xlog::debug("Gear in row {} has neighbours {} and {}", row, neighbours[0], neighbours[1]);
-      return neighbours[0] * neighbours[1];
-    });
-}
\ No newline at end of file
+std::uint64_t Day03::part2() {
+  return scan(this->input).gear_ratios;
+}
@@ -1,12 +1,16 @@
 #include "day04.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <execution>
 #include <format>
 #include <functional>
 #include <numeric>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -22,23 +26,36 @@ namespace {
   return std::make_pair(nrows, ncols);
 }
 
-[[nodiscard]] std::uint64_t card_hits(const std::size_t row,
-  const std::string::const_iterator begin,
-  const std::string::const_iterator end) {
-  auto it = std::find(begin, end, ':');
-  if (it == end) {
-    throw std::runtime_error(std::format("Row {} has no colon (:)", row));
-  }
+// Set of card numbers, one bit per number. Card numbers are below 100, so two words suffice.
+struct number_set {
+  std::array<std::uint64_t, 2> words{};
 
-  std::vector<int> winners;
+  void insert(const std::size_t row, const unsigned n) {
+    if (n >= 128) {
+      throw std::runtime_error(std::format("Row {} has number {}, which is too large", row, n));
+    }
+    words[n / 64] |= std::uint64_t{1} << (n % 64);
+  }
 
-  // parse winners
-  int n = 0;
+  [[nodiscard]] std::size_t intersection_size(number_set const& other) const noexcept {
+    return static_cast<std::size_t>(std::popcount(words[0] & other.words[0]) +
+                                    std::popcount(words[1] & other.words[1]));
+  }
+};
+
+// Parses space-separated numbers until the delimiter (or the end of the range) is found.
+// Returns an iterator past the delimiter.
+std::string::const_iterator parse_numbers(const std::size_t row,
+  std::string::const_iterator it,
+  const std::string::const_iterator end,
+  const char delimiter,
+  number_set& out) {
+  unsigned n = 0;
   bool num = false;
-  for (it = it + 1; it != end && *it != '|'; ++it) {
-    if (*it == ' ') {
+  for (; it != end && *it != delimiter; ++it) {
+    if (*it == ' ' || *it == '\n') {
       if (num) {
-        winners.push_back(n);
+        out.insert(row, n);
       }
       n = 0;
       num = false;
@@ -46,93 +63,82 @@ namespace {
     }
 
     num = true;
-    n = 10 * n + (*it - '0');
+    n = 10 * n + static_cast<unsigned>(*it - '0');
   }
 
-  std::ranges::sort(winners);
+  if (num) {
+    out.insert(row, n);
+  }
 
-  // parse numbers we have
-  std::uint64_t hits = 0;
-  n = 0;
-  num = false;
+  return it == end ? it : it + 1;
+}
 
-  if (it != end) { // *it == '|'
-    ++it;
+[[nodiscard]] std::uint64_t card_hits(const std::size_t row,
+  const std::string::const_iterator begin,
+  const std::string::const_iterator end) {
+  auto it = std::find(begin, end, ':');
+  if (it == end) {
+    throw std::runtime_error(std::format("Row {} has no colon (:)", row));
   }
-  for (; it != end; ++it) {
-    if (*it == ' ' || *it == '\n') {
-      if (num && std::ranges::binary_search(winners, n)) {
-        ++hits;
-      }
-      num = false;
-      n = 0;
-      continue;
-    }
 
-    num = true;
-    n = 10 * n + (*it - '0');
-  }
+  number_set winners;
+  number_set owned;
+  it = parse_numbers(row, it + 1, end, '|', winners);
+  parse_numbers(row, it, end, '\n', owned);
 
-  return hits;
+  return winners.intersection_size(owned);
 }
 
-} // namespace
-
-std::uint64_t Day04::part1() {
-  const auto [nrows, ncols] = dimensions(this->input);
+// Computes the hits of every card. Cards are independent, so they are matched in parallel.
+[[nodiscard]] std::vector<std::uint64_t> all_card_hits(std::string const& input) {
+  const auto [nrows, ncols] = dimensions(input);
 
   std::vector<std::size_t> rows(nrows, 0);
   std::iota(rows.begin(), rows.end(), 0);
 
-  return std::transform_reduce(std::execution::par_unseq, rows.begin(), rows.end(), 0u, std::plus{},
-    [this, ncols](std::size_t const row) -> std::uint64_t {
+  std::vector<std::uint64_t> hits(nrows);
+  std::transform(std::execution::par_unseq, rows.cbegin(), rows.cend(), hits.begin(),
+    [&input, ncols](std::size_t const row) -> std::uint64_t {
       const auto begin = input.cbegin() + static_cast<std::ptrdiff_t>(row * ncols);
       const auto end = begin + static_cast<std::ptrdiff_t>(ncols);
+      return card_hits(row, begin, end);
+    });
 
-      const auto hits = card_hits(row, begin, end);
+  return hits;
+}
 
-      std::uint64_t score = 0;
-      if (hits > 0) {
-        score = 1 << (hits - 1);
-      }
+} // namespace
 
-      xlog::debug("Card {} has a score of {}", row + 1, score);
-      return score;
+std::uint64_t Day04::part1() {
+  const auto hits = all_card_hits(this->input);
+
+  return std::transform_reduce(std::execution::par_unseq, hits.cbegin(), hits.cend(),
+    std::uint64_t{0}, std::plus{}, [](std::uint64_t const h) -> std::uint64_t {
+      return h == 0 ? 0 : std::uint64_t{1} << (h - 1);
     });
 }
 
 std::uint64_t Day04::part2() {
-  const auto [nrows, ncols] = dimensions(this->input);
-
-  std::vector<std::size_t> rows(nrows, 0);
-  std::iota(rows.begin(), rows.end(), 0);
-
-  // Parse in parallel, compute how many hits per card
-  std::vector<std::int64_t> hits(nrows);
-  std::transform(rows.cbegin(), rows.cend(), hits.begin(),
-    [this, ncols](std::size_t const row) -> std::uint64_t {
-      const auto begin = input.cbegin() + static_cast<std::ptrdiff_t>(row * ncols);
-      const auto end = begin + static_cast<std::ptrdiff_t>(ncols);
-      return card_hits(row, begin, end);
-    });
+  const auto hits = all_card_hits(this->input);
+  const auto ncards = hits.size();
 
-  // Must not be parallel because we overwrite copies
-  std::vector<std::uint64_t> copies(nrows, 1);
-  std::transform(rows.begin(), rows.end(), copies.begin(),
-    [&hits, &copies](std::size_t const row) -> std::uint64_t {
-      const auto nhits = hits[row];
-      const auto ncopies = copies[row];
+  // Difference array: every card adds its copies to a range of later cards, which is
+  // recorded as an increment at the start of the range and a decrement past its end.
+  std::vector<std::uint64_t> delta(ncards + 1, 0);
 
-      xlog::debug("Game {}: there are {} copies with {} hits each", row + 1, ncopies, nhits);
+  std::uint64_t total = 0;
+  std::uint64_t extra = 0;
+  for (std::size_t card = 0; card < ncards; ++card) {
+    extra += delta[card];
+    const std::uint64_t ncopies = 1 + extra;
+    total += ncopies;
 
-      // Add copies of following cards
-      auto mbegin = copies.begin() + static_cast<std::ptrdiff_t>(row) + 1;
-      auto mend = mbegin + nhits;
-      std::transform(mbegin, mend, mbegin, [ncopies](auto& m) { return m + ncopies; });
+    xlog::debug("Game {}: there are {} copies with {} hits each", card + 1, ncopies, hits[card]);
 
-      return ncopies;
-    });
+    const auto last = std::min(ncards, card + 1 + hits[card]);
+    delta[card + 1] += ncopies;
+    delta[last] -= ncopies;
+  }
 
-  // std::ranges::reduce does not exist >:(
-  return std::reduce(copies.begin(), copies.end());
+  return total;
 }
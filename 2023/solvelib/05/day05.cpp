@@ -1,6 +1,8 @@
 #include "day05.hpp"
 
+#include "xmaslib/arena/arena.hpp"
 #include "xmaslib/integer_range/integer_range.hpp"
+#include "xmaslib/integer_range/interval_set.hpp"
 #include "xmaslib/line_iterator/line_iterator.hpp"
 #include "xmaslib/log/log.hpp"
 #include "xmaslib/parsing/parsing.hpp"
@@ -51,12 +53,16 @@ struct mapping {
 };
 
 using intrange = xmas::integer_range<std::uint64_t>;
+using intset = xmas::pmr::interval_set<std::uint64_t>;
 
 // a translation layer, such as "seed-to-soil map"
 struct layer {
   // src->dest,len triplets
   std::vector<mapping> mappings;
 
+  // The same mappings, as a piecewise translation of ranges
+  std::vector<intset::piece> pieces;
+
   // Takes a source and returns the destination
   std::uint64_t translate(std::uint64_t x) const {
     std::size_t lo = 0;
@@ -81,49 +87,9 @@ struct layer {
     return x;
   }
 
-  // Takes a set of sources and returns the destinations
-  // No guarantees on output ordering
-  std::vector<intrange> translate(intrange in) const {
-    std::vector<intrange> out;
-
-    // Process the input range from left to right, until we have no input range
-    // left.
-    for (mapping const& m : mappings) {
-      if (m.src + m.len < in.begin) {
-        // mapping is to the left of the input range
-        continue;
-      }
-      if (in.end <= m.src) {
-        // mapping is to the right of the input range
-        continue;
-      }
-
-      // There is an overlap
-      auto overlap = in.overlap({m.src, m.src + m.len});
-
-      // Snip leading part of input range (stays as-is)
-      if (in.begin < overlap.begin) {
-        out.emplace_back(in.drop_less(overlap.begin));
-      }
-
-      // Map the overlap from src to dest
-      auto begin_delta = overlap.begin - m.src;
-      auto end_delta = overlap.end - m.src;
-      out.emplace_back(m.dest + begin_delta, m.dest + end_delta);
-
-      // Process right tail (if there is one)
-      in.begin = overlap.end;
-      if (in.empty()) {
-        break;
-      }
-    }
-
-    // Append the right tail
-    if (in.begin < in.end) {
-      out.push_back(in);
-    }
-
-    return out;
+  // Takes a set of sources and writes the destinations into out
+  void translate(intset const& in, intset& out) const {
+    in.translate(pieces, out);
   }
 
   // After parsing the mappings (source->dest pairs), we sort them according to
@@ -131,6 +97,11 @@ struct layer {
   void commit() {
     std::ranges::sort(mappings, [](mapping const& a, mapping const& b) { return a.src < b.src; });
 
+    pieces.clear();
+    for (mapping const& m : mappings) {
+      pieces.push_back({.from = {m.src, m.src + m.len}, .to = m.dest});
+    }
+
     // Validate no overlap between ranges, throw in case there is
     // That would mean a bad input (or me misunderstanding the problem :P)
 #ifndef NDEBUG
@@ -184,15 +155,6 @@ std::pair<layer, xmas::views::linewise::iterator> parse_layer(xmas::views::linew
   return {l, it};
 }
 
-// Appends the contents of src at the end of dst
-template <typename T>
-void extend(std::vector<T>& dst, std::vector<T> const& src) {
-  std::size_t old_size = dst.size();
-  dst.resize(old_size + src.size());
-  std::copy(std::execution::unseq, src.begin(), src.end(),
-    dst.begin() + static_cast<std::ptrdiff_t>(old_size));
-}
-
 } // namespace
 
 std::uint64_t Day05::part1() {
@@ -261,25 +223,21 @@ std::uint64_t Day05::part2() {
     iline = r.second;
   }
 
-  // Computing each seed range in parallel
-  return std::transform_reduce(
-    std::execution::par_unseq, seed_ranges.cbegin(), seed_ranges.cend(),
-    std::numeric_limits<std::uint64_t>::max(),
-    [](std::uint64_t x, std::uint64_t y) { return x < y ? x : y; }, /* min */
-    [&layers](const intrange seed_range) -> std::uint64_t {
-      std::vector<intrange> ranges = {seed_range};
-      for (auto const& layer : layers) {
-        std::vector<intrange> input = std::move(ranges);
-        ranges = {};
-        for (auto& i : input) {
-          extend(ranges, layer.translate(i));
-        }
+  // All seed ranges travel through the layers together, in two sets that swap roles
+  auto* mem = scratch.resource();
+  intset ranges(mem);
+  intset next(mem);
+  for (auto r : seed_ranges) {
+    ranges.insert(r);
+  }
 
-        xmas::coalesce_ranges(ranges);
-      }
-      const auto best = ranges.front().begin;
+  for (auto const& layer : layers) {
+    layer.translate(ranges, next);
+    std::swap(ranges, next);
+  }
 
-      xlog::debug("[{}, {}) -> {}", seed_range.begin, seed_range.end, best);
-      return best;
-    });
+  if (ranges.empty()) {
+    throw std::runtime_error("there are no seeds");
+  }
+  return ranges.front().begin;
 }
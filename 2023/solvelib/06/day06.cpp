@@ -1,11 +1,11 @@
 #include "day06.hpp"
+#include "race.hpp"
 
 #include "xmaslib/line_iterator/line_iterator.hpp"
 #include "xmaslib/log/log.hpp"
 #include "xmaslib/parsing/parsing.hpp"
 
 #include <cassert>
-#include <cmath>
 #include <cstdint>
 #include <execution>
 #include <functional>
@@ -27,26 +27,9 @@ std::uint64_t parse_int_ignore_nonnumeric(std::string_view str) {
 }
 
 std::uint64_t count_wins(std::uint64_t time, std::uint64_t distance) noexcept {
-  // Solve quadratic equation:
-  //
-  //    d=t(T - t)
-  //
-  //  > d is the distance+1 (aka the minimum distance to win)
-  //  > T is the race duration
-  //  > t is the charging time.
-  //  The equation simplifies down:
-  //
-  //  t = -(T/2) ± sqrt((T/2)^2 - d)
-  auto T = static_cast<double>(time);
-  auto D = static_cast<double>(distance) + 1;
-
-  double half = T / 2;
-  double delta = std::sqrt(half * half - D);
-  auto min_t = std::uint64_t(std::ceil(half - delta));
-  auto max_t = std::uint64_t(std::floor(half + delta));
-
-  xlog::debug("Race {},{} -> [{}, {}]", time, distance, int(min_t), int(max_t));
-  return max_t - min_t + 1;
+  const auto wins = race::count_wins(time, distance);
+  xlog::debug("Race {},{} -> {} ways to win", time, distance, wins);
+  return wins;
 }
 
 } // namespace
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "bench/bench.hpp"
+
+#include "race.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <vector>
+
+namespace day06_bench {
+
+// The floating point solver that the exact one replaced, kept as a reference
+inline std::uint64_t count_wins_float(std::uint64_t time, std::uint64_t distance) {
+  const auto half = static_cast<double>(time) / 2;
+  const double delta = std::sqrt(half * half - static_cast<double>(distance) - 1);
+  return std::uint64_t(std::floor(half + delta)) - std::uint64_t(std::ceil(half - delta)) + 1;
+}
+
+struct race_input {
+  std::uint64_t time;
+  std::uint64_t distance;
+};
+
+// Generates races with times below max_time and distances up to the best possible one
+inline std::vector<race_input> random_races(std::size_t n, std::uint64_t max_time) {
+  std::vector<race_input> races;
+  races.reserve(n);
+
+  std::uint64_t state = 42;
+  const auto next = [&state] {
+    state = state * 6364136223846793005u + 1442695040888963407u;
+    return state;
+  };
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto time = next() % max_time;
+    const auto best = static_cast<std::uint64_t>(xmas::uint128_t{time / 2} * (time - time / 2));
+    races.push_back({time, best == 0 ? 0 : next() % best});
+  }
+
+  return races;
+}
+
+// Counts the races where the solver disagrees with the brute force reference
+template <typename F>
+std::size_t fuzz(std::vector<race_input> const& races, F&& solver) {
+  std::size_t mismatches = 0;
+  for (auto [time, distance] : races) {
+    if (solver(time, distance) != race::count_wins_brute_force(time, distance)) {
+      ++mismatches;
+    }
+  }
+  return mismatches;
+}
+
+template <typename F>
+bench::stats time_solver(std::vector<race_input> const& races, F&& solver) {
+  return bench::run([&] {
+    std::uint64_t acc = 0;
+    for (auto [time, distance] : races) {
+      acc += solver(time, distance);
+    }
+    bench::do_not_optimize(acc);
+  });
+}
+
+inline const bench::registration registration("day06_count_wins", [] {
+  const auto exact = [](std::uint64_t t, std::uint64_t d) { return race::count_wins(t, d); };
+  const auto brute = [](std::uint64_t t, std::uint64_t d) {
+    return race::count_wins_brute_force(t, d);
+  };
+
+  // Fuzzing against brute force is only feasible for short races
+  for (std::uint64_t max_time : {100, 10'000}) {
+    const auto races = random_races(1000, max_time);
+
+    if (auto n = fuzz(races, exact); n != 0) {
+      xlog::error("day06_count_wins: exact solver failed {} races with time < {}", n, max_time);
+      return;
+    }
+    if (auto n = fuzz(races, count_wins_float); n != 0) {
+      xlog::warning("day06_count_wins: float solver failed {} races with time < {}", n, max_time);
+    }
+
+    bench::report("day06_count_wins", std::format("brute {}", max_time), time_solver(races, brute));
+    bench::report("day06_count_wins", std::format("float {}", max_time),
+      time_solver(races, count_wins_float));
+    bench::report("day06_count_wins", std::format("exact {}", max_time), time_solver(races, exact));
+  }
+
+  // Races too long for brute force are checked against the defining inequality instead
+  const auto giant = random_races(1000, std::uint64_t{1} << 63);
+  for (auto [time, distance] : giant) {
+    const auto wins = race::count_wins(time, distance);
+    const auto first = (time - wins + 1) / 2;
+    if (wins == 0 || !race::beats(time, distance, first) ||
+        race::beats(time, distance, first - 1)) {
+      xlog::error("day06_count_wins: exact solver failed race {},{}", time, distance);
+      return;
+    }
+  }
+
+  bench::report("day06_count_wins", "float giant", time_solver(giant, count_wins_float));
+  bench::report("day06_count_wins", "exact giant", time_solver(giant, exact));
+});
+
+} // namespace day06_bench
@@ -1,4 +1,8 @@
 #include "day06.hpp"
+#include "race.hpp"
+
+#include <cstdint>
+#include <limits>
 #include <doctest/doctest.h>
 
 TEST_CASE("Day 06") {
@@ -24,4 +28,26 @@ TEST_CASE("Day 06") {
     REQUIRE_EQ(solution.part1(), 588588);
     REQUIRE_EQ(solution.part2(), 34655848);
   }
-}
\ No newline at end of file
+
+  SUBCASE("Exact solver") {
+    for (std::uint32_t time = 0; time < 300; ++time) {
+      for (std::uint32_t distance = 0; distance <= time * time / 4 + 1; distance += 1 + time / 8) {
+        REQUIRE_EQ(race::count_wins(time, distance), race::count_wins_brute_force(time, distance));
+      }
+    }
+  }
+
+  SUBCASE("Giant races") {
+    // Floating point solvers lose precision this far away from zero
+    constexpr std::uint64_t time = std::uint64_t{1} << 32;
+    constexpr std::uint64_t best = (time / 2) * (time / 2);
+
+    REQUIRE_EQ(race::count_wins(time, best - 1), 1);
+    REQUIRE_EQ(race::count_wins(time, best), 0);
+    REQUIRE_EQ(race::count_wins(time + 1, best + time / 2 - 1), 2);
+    REQUIRE_EQ(race::count_wins(time + 1, best + time / 2), 0);
+
+    constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+    REQUIRE_EQ(race::count_wins(max, max), max - 3);
+  }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "xmaslib/math/isqrt.hpp"
+
+namespace race {
+
+// Whether charging for `charge` out of `time` milliseconds travels further than `distance`.
+// The product is computed in the wider type so that it cannot overflow.
+template <typename T>
+[[nodiscard]] constexpr bool beats(T time, T distance, T charge) noexcept {
+  using W = xmas::wider_t<T>;
+  return W{charge} * W(time - charge) > W{distance};
+}
+
+// Counts the charging times that beat the record, by brute force.
+template <typename T>
+[[nodiscard]] constexpr T count_wins_brute_force(T time, T distance) noexcept {
+  T count = 0;
+  for (T t = 0; t <= time / 2; ++t) {
+    count = static_cast<T>(count + (beats(time, distance, t) ? 1 : 0));
+  }
+  // Every winning t below time/2 has a twin at time-t, except t=time/2 for even times
+  count = static_cast<T>(2 * count);
+  if (time % 2 == 0 && beats(time, distance, static_cast<T>(time / 2))) {
+    --count;
+  }
+  return count;
+}
+
+/*
+count_wins counts the charging times t such that t(time - t) > distance.
+
+The winning times lie between the roots of t² - time·t + distance = 0, which are
+(time ± √(time² - 4·distance)) / 2. The discriminant is computed in the wider
+type and its root with an exact integer square root, so the result is exact for
+any T. Flooring can misplace the first winning time by one, which is fixed by
+testing its neighbours. The last one follows by symmetry.
+*/
+template <typename T>
+[[nodiscard]] constexpr T count_wins(T time, T distance) noexcept {
+  using W = xmas::wider_t<T>;
+
+  const W squared = W{time} * W{time};
+  const auto four_d = static_cast<W>(4 * W{distance});
+  if (squared < four_d) {
+    return 0;
+  }
+
+  const auto root = static_cast<T>(xmas::isqrt(static_cast<W>(squared - four_d)));
+  auto first = static_cast<T>((time - root) / 2);
+
+  const T half = time / 2;
+  while (first <= half && !beats(time, distance, first)) {
+    ++first;
+  }
+  while (first > 0 && beats(time, distance, static_cast<T>(first - 1))) {
+    --first;
+  }
+
+  if (first > half) {
+    return 0;
+  }
+
+  return static_cast<T>(time - 2 * first + 1);
+}
+
+} // namespace race
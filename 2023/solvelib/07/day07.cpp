@@ -3,7 +3,7 @@
 #include "xmaslib/iota/iota.hpp"
 #include "xmaslib/log/log.hpp"
 #include "xmaslib/parsing/parsing.hpp"
-#include "xmaslib/line_iterator/line_iterator.hpp"
+#include "xmaslib/line_index/line_index.hpp"
 
 #include <algorithm>
 #include <array>
@@ -16,6 +16,8 @@
 #include <span>
 #include <stdexcept>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace {
 
@@ -72,35 +74,39 @@ std::uint32_t encode_card(char card) {
   }
 }
 
-constexpr std::array<std::uint8_t, 0xf> empty_score_array = {
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}; // No clean way of doing this apparently
+// The sum of the squares of the card counts is unique for every hand type:
+// 5² = 25, 4²+1² = 17, 3²+2² = 13, 3²+1²+1² = 11, 2²+2²+1² = 9, 2²+1²+1²+1² = 7, and 5×1² = 5
+constexpr std::array<type, 26> type_by_square_sum = [] {
+  std::array<type, 26> t{};
+  t[25] = penta;
+  t[17] = quadra;
+  t[13] = full_house;
+  t[11] = triple;
+  t[9] = two_pair;
+  t[7] = pair;
+  t[5] = high;
+  return t;
+}();
 
 template <bool is_part_2>
 type compute_type(hand hand) {
-  auto counts = empty_score_array;
+  std::array<std::uint32_t, 0xf> counts{};
+  std::uint32_t square_sum = 0;
   for (char card : hand) {
-    ++counts[encode_card<is_part_2>(card)];
+    auto& count = counts[encode_card<is_part_2>(card)];
+    square_sum += 2 * count + 1; // (n+1)² = n² + 2n + 1
+    ++count;
   }
 
-  auto joker_count = std::exchange(counts[0], 0); // Will be 0 when is_part2 == false
-  std::partial_sort(std::execution::unseq, counts.begin(), counts.begin() + 2, counts.end(),
-    std::greater<std::uint8_t>{});
-  counts[0] += joker_count;
-
-  switch (counts[0]) {
-  case 5:
-    return penta;
-  case 4:
-    return quadra;
-  case 3:
-    return counts[1] == 2 ? full_house : triple;
-  case 2:
-    return counts[1] == 2 ? two_pair : pair;
-  case 1:
-    return high;
-  [[unlikely]] default:
-    throw std::runtime_error("Could not parse hand");
+  if constexpr (is_part_2) {
+    // Jokers join the most common card
+    const auto jokers = std::exchange(counts[0], 0);
+    const auto most_common = std::ranges::max(counts);
+    square_sum -= jokers * jokers + most_common * most_common;
+    square_sum += (most_common + jokers) * (most_common + jokers);
   }
+
+  return type_by_square_sum[square_sum];
 }
 
 template <bool is_part_2>
@@ -130,14 +136,48 @@ std::uint64_t extract_bid(player_t player) {
   return static_cast<score_t>(player & 0xffffffff);
 }
 
+// radix_sort sorts the players by their whole encoding with an LSD radix sort, one byte at a
+// time. Players with the same hand are thus ordered by bid, as std::sort on the encoding did.
+void radix_sort(std::vector<player_t>& players) {
+  constexpr std::size_t radix_bits = 8;
+  constexpr std::size_t n_buckets = 1 << radix_bits;
+
+  std::vector<player_t> buffer(players.size());
+  for (std::size_t shift = 0; shift < 64; shift += radix_bits) {
+    const auto digit = [shift](player_t p) { return (p >> shift) & (n_buckets - 1); };
+
+    std::array<std::size_t, n_buckets> offsets{};
+    for (player_t p : players) {
+      ++offsets[digit(p)];
+    }
+
+    // All players share this digit: nothing to sort
+    if (offsets[digit(players.front())] == players.size()) {
+      continue;
+    }
+
+    std::exclusive_scan(offsets.begin(), offsets.end(), offsets.begin(), std::size_t{0});
+    for (player_t p : players) {
+      buffer[offsets[digit(p)]++] = p;
+    }
+    std::swap(players, buffer);
+  }
+}
+
 template <bool is_part_2>
 std::uint64_t solve(std::string_view input) {
-  std::vector<player_t> players;
+  const xmas::views::line_index lines(input);
+  std::vector<player_t> players(lines.size());
+
+  // Sequential, because encode_player throws on malformed hands, and an exception that escapes
+  // a parallel algorithm terminates the program
+  std::transform(lines.begin(), lines.end(), players.begin(), encode_player<is_part_2>);
 
-  auto lines = xmas::views::linewise(input);
-  std::transform(lines.begin(), lines.end(), std::back_inserter(players), encode_player<is_part_2>);
+  if (players.empty()) {
+    return 0;
+  }
 
-  std::sort(players.begin(), players.end(), std::less<player_t>{});
+  radix_sort(players);
 
   xmas::views::iota<std::uint64_t> position(1, 1 + players.size());
   return std::transform_reduce(std::execution::par_unseq, players.begin(), players.end(),
@@ -17,6 +17,15 @@ TEST_CASE("Day 07") {
     REQUIRE_EQ(solution.part2(), 5905);
   }
 
+  SUBCASE("Repeated hands") {
+    // Players with the same hand are ranked by bid
+    Day07 solution{};
+    solution.set_input("./data/07/ties.txt");
+    solution.load();
+    REQUIRE_EQ(solution.part1(), 19);
+    REQUIRE_EQ(solution.part2(), 19);
+  }
+
   SUBCASE("Real data") {
     Day07 solution{};
     solution.set_input("./data/07/input.txt");
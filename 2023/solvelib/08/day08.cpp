@@ -1,4 +1,5 @@
 #include "day08.hpp"
+#include "xmaslib/cycle/cycle.hpp"
 #include "xmaslib/iota/iota.hpp"
 #include "xmaslib/log/log.hpp"
 
@@ -13,7 +14,7 @@
 #include <linux/limits.h>
 #include <numeric>
 #include <ranges>
-#include <set>
+#include <utility>
 #include <stdexcept>
 #include <string_view>
 #include <map>
@@ -78,33 +79,32 @@ auto find(std::map<std::string, node> const& network, std::string const& node_na
 std::optional<std::uint64_t> solve(std::string_view instr,
   std::map<std::string, node> const& network, std::string const& from, std::string const& to) {
 
-  auto curr_node = find(network, from);
+  // The walk is fully determined by the current node and the position in the instructions,
+  // so it is impossible to reach the destination if this pair repeats first.
+  struct walker {
+    std::map<std::string, node>::const_iterator at;
+    std::size_t cursor;
+  };
 
-  std::set<std::pair<std::string const*, std::uint64_t>> visited{};
+  const auto step = [&](walker& w) {
+    const auto& next = instr[w.cursor] == 'R' ? w.at->second.right : w.at->second.left;
+    w.at = find(network, next);
+    w.cursor = (w.cursor + 1) % instr.size();
+  };
 
-  std::uint64_t count = 0;
-  while (curr_node->first != to) {
-    auto cursor = count % instr.size();
+  const auto snapshot = [](walker const& w) { return std::pair{&w.at->first, w.cursor}; };
 
-    auto [it, is_new] = visited.emplace(&curr_node->first, cursor);
-    if (!is_new) {
-      xlog::debug("Routing {} to {} is impossible", from, to);
-      return {};
-    }
+  walker w{.at = find(network, from), .cursor = 0};
+  auto count = xmas::cycle::steps_until(
+    w, step, snapshot, [&](walker const& v) { return v.at->first == to; });
 
-    auto search = [&]() -> std::string const& {
-      auto move = instr.at(cursor);
-      if (move == 'R') {
-        return curr_node->second.right;
-      }
-      return curr_node->second.left;
-    }();
-    ++count;
-    curr_node = find(network, search);
+  if (!count.has_value()) {
+    xlog::debug("Routing {} to {} is impossible", from, to);
+    return {};
   }
 
-  xlog::debug("Routing {} to {} takes {} cycles", from, to, count);
-  return {count};
+  xlog::debug("Routing {} to {} takes {} cycles", from, to, *count);
+  return {*count};
 }
 
 }
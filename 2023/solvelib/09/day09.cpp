@@ -1,51 +1,100 @@
 #include "day09.hpp"
 
-#include "xmaslib/functional/functional.hpp"
 #include "xmaslib/log/log.hpp"
 #include "xmaslib/line_iterator/line_iterator.hpp"
-#include "xmaslib/parsing/parsing.hpp"
 
 #include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
 #include <execution>
+#include <format>
 #include <functional>
+#include <map>
 #include <numeric>
+#include <stdexcept>
 #include <string_view>
+#include <system_error>
 #include <vector>
 
 namespace {
 
+// Extending a sequence by taking differences until they are constant is the same as
+// evaluating the polynomial of degree < n that goes through its n values. Hence, the
+// extrapolated value is a fixed linear combination of the values, with binomial weights:
+//
+// Forward:  x[n]  = Σ (-1)^(n-1-i) C(n, i)   x[i]
+// Backward: x[-1] = Σ (-1)^i       C(n, i+1) x[i]
 template <bool reverse>
-std::int64_t extend(std::span<std::int64_t> values) {
-  std::vector<std::int64_t> diffs(values.size() - 1);
-  std::transform(std::execution::unseq, values.begin() + 1, values.end(), values.begin(),
-    diffs.begin(), std::minus<std::int64_t>{});
-
-  bool same_diff = std::all_of(
-    std::execution::unseq, diffs.begin(), diffs.end(), xmas::equals<std::int64_t>(diffs.back()));
+std::vector<std::int64_t> extrapolation_weights(std::size_t n) {
+  std::vector<std::int64_t> binomial(n + 1);
+  binomial[0] = 1;
+  for (std::size_t k = 0; k < n; ++k) {
+    binomial[k + 1] =
+      binomial[k] * static_cast<std::int64_t>(n - k) / static_cast<std::int64_t>(k + 1);
+  }
 
-  if (reverse) {
-    if (same_diff) {
-      return values.front() - diffs.front();
+  std::vector<std::int64_t> weights(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    if constexpr (reverse) {
+      weights[i] = (i % 2 == 0 ? 1 : -1) * binomial[i + 1];
+    } else {
+      weights[i] = ((n - 1 - i) % 2 == 0 ? 1 : -1) * binomial[i];
     }
-    return values.front() - extend<reverse>(diffs);
   }
 
-  if (same_diff) {
-    return values.back() + diffs.back();
+  return weights;
+}
+
+// parse_line parses the space-separated integers in a line into out, reusing its storage.
+void parse_line(std::string_view line, std::vector<std::int64_t>& out) {
+  out.clear();
+
+  const char* it = line.data();
+  const char* const end = line.data() + line.size();
+  while (it != end) {
+    if (*it == ' ') {
+      ++it;
+      continue;
+    }
+
+    std::int64_t x{};
+    auto [ptr, ec] = std::from_chars(it, end, x);
+    if (ec != std::errc{}) {
+      throw std::runtime_error(std::format("Could not parse line '{}'", line));
+    }
+
+    out.push_back(x);
+    it = ptr;
   }
-  return values.back() + extend<reverse>(diffs);
 }
 
 template <bool reverse>
 std::uint64_t solve(std::string_view input) {
-  xmas::views::linewise lines(input);
+  // Extrapolation is linear, so all sequences of the same length are added up column-wise
+  // and then extrapolated together with a single dot product.
+  std::map<std::size_t, std::vector<std::int64_t>> column_sums;
 
-  std::vector<std::vector<std::int64_t>> data;
-  std::transform(
-    lines.begin(), lines.end(), std::back_inserter(data), xmas::parse_ints<std::int64_t>);
+  std::vector<std::int64_t> values;
+  for (auto line : xmas::views::linewise(input)) {
+    parse_line(line, values);
+    if (values.empty()) {
+      continue;
+    }
+
+    auto& sums = column_sums[values.size()];
+    sums.resize(values.size());
+    std::transform(std::execution::unseq, values.begin(), values.end(), sums.begin(), sums.begin(),
+      std::plus<std::int64_t>{});
+  }
 
-  std::int64_t n = std::transform_reduce(
-    data.begin(), data.end(), std::int64_t{0}, std::plus<std::int64_t>{}, extend<reverse>);
+  std::int64_t n = std::transform_reduce(column_sums.begin(), column_sums.end(), std::int64_t{0},
+    std::plus<std::int64_t>{}, [](auto const& entry) {
+      auto const& [length, sums] = entry;
+      const auto weights = extrapolation_weights<reverse>(length);
+      return std::transform_reduce(
+        std::execution::unseq, weights.begin(), weights.end(), sums.begin(), std::int64_t{0});
+    });
 
   if (n < 0) {
     xlog::warning("Solution is negative: {}", n);
@@ -1,154 +1,164 @@
 #include "day10.hpp"
 
 #include "xmaslib/log/log.hpp"
-#include "xmaslib/matrix/text_matrix.hpp"
 
-#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
-#include <execution>
-#include <functional>
-#include <numeric>
+#include <format>
 #include <optional>
 #include <stdexcept>
-#include <vector>
+#include <string_view>
+#include <utility>
 
 namespace {
 
 using Int = std::int64_t;
 
-struct coords {
-  Int r;
-  Int c;
-};
-
-enum heading {
+enum heading : std::uint8_t {
   N,
   E,
   S,
   W,
 };
 
-std::optional<heading> update_heading(
-  xmas::views::text_matrix map, coords pos, heading curr_heading) {
-  switch (map.at(pos)) {
-  case 'F':
-    switch (curr_heading) {
-    case N:
-      return E;
-    case W:
-      return S;
-    default:
-      return {};
-    }
-  case 'L':
-    switch (curr_heading) {
-    case S:
-      return E;
-    case W:
-      return N;
-    default:
-      return {};
-    }
-  case '|':
-    switch (curr_heading) {
-    case N:
-      return N;
-    case S:
-      return S;
-    default:
-      return {};
-    }
-  case '-':
-    switch (curr_heading) {
-    case E:
-      return E;
-    case W:
-      return W;
-    default:
-      return {};
-    }
-  case '7':
-    switch (curr_heading) {
-    case E:
-      return S;
-    case N:
-      return W;
-    default:
-      return {};
-    }
-  case 'J':
-    switch (curr_heading) {
-    case S:
-      return W;
-    case E:
-      return N;
-    default:
-      return {};
-    }
-  case '.':
-    return {};
-  case 'S':
-    return {};
-  }
+constexpr std::array<heading, 4> headings{N, E, S, W};
 
-  throw std::runtime_error(std::format("unexpected cell with value {}", map.at(pos)));
-}
+// Markers in the turn table for cells that a heading cannot continue through
+constexpr std::uint8_t blocked = 4;
+constexpr std::uint8_t unknown = 5;
 
-std::optional<coords> take_step(xmas::views::text_matrix map, coords pos, heading heading) {
-  // clang-format off
-  switch (heading) {
-  case N:
-    if(pos.r == 0) return {};
-    return {{pos.r - 1, pos.c}};
-  case S:
-    if(std::size_t(pos.r+1) == map.nrows()) return {};
-    return {{pos.r + 1, pos.c}};
-  case W:
-    if(pos.c == 0) return {};
-    return {{pos.r, pos.c - 1}};
-  case E:
-    if(std::size_t(pos.c+1) == map.ncols()) return {};
-    return {{pos.r, pos.c + 1}};
+// turns[cell][heading] is the heading after entering a cell, or one of the markers above
+constexpr auto turns = [] {
+  std::array<std::array<std::uint8_t, 4>, 256> table{};
+  for (auto& row : table) {
+    row.fill(unknown);
   }
-  // clang-format on
 
-  throw std::runtime_error("Invalid value for heading");
-}
+  // Pipes and the two sides they open to
+  constexpr std::array<std::pair<char, std::array<heading, 2>>, 6> pipes{{
+    {'|', {N, S}},
+    {'-', {E, W}},
+    {'L', {N, E}},
+    {'J', {N, W}},
+    {'7', {S, W}},
+    {'F', {S, E}},
+  }};
+
+  for (char ch : {'.', 'S', '\n'}) {
+    table[std::uint8_t(ch)].fill(blocked);
+  }
 
-heading find_start_direction(xmas::views::text_matrix map, coords start) {
-  std::vector<heading> possible_headings;
+  for (auto const& [ch, sides] : pipes) {
+    auto& row = table[std::uint8_t(ch)];
+    row.fill(blocked);
+    // Entering with heading h means coming in through the opposite side
+    row[(sides[0] + 2) % 4] = sides[1];
+    row[(sides[1] + 2) % 4] = sides[0];
+  }
 
-  // North side
-  if (start.r != 0) {
-    if (update_heading(map, {start.r - 1, start.c}, N).has_value()) {
-      possible_headings.push_back(N);
-    }
+  return table;
+}();
+
+/*
+walker follows the loop over the raw input, where cells are addressed by their flat index.
+
+Stepping past the left or right edge lands on a newline, which blocks every heading, and
+stepping past the top or bottom wraps around to an index out of range. The loop is never
+stored: its length and its shoelace area are accumulated while walking.
+*/
+class walker {
+public:
+  walker(std::string_view map, std::size_t start) :
+      map(map), stride(map.find('\n') + 1), start(start),
+      offsets{std::size_t{0} - stride, 1, stride, std::size_t{0} - 1} {
+    assert(map[start] == 'S');
   }
 
-  // South side
-  if (std::size_t(start.r + 1) != map.nrows()) {
-    if (update_heading(map, {start.r + 1, start.c}, S).has_value()) {
-      possible_headings.push_back(S);
-    }
+  // Whether a step in this direction from the start enters a pipe that continues the loop
+  [[nodiscard]] bool can_start(heading h) const {
+    const std::size_t next = start + offsets[h];
+    return next < map.size() && turns[std::uint8_t(map[next])][h] < blocked;
   }
 
-  // West side
-  if (start.c != 0) {
-    if (update_heading(map, {start.r, start.c - 1}, W).has_value()) {
-      possible_headings.push_back(W);
+  struct loop {
+    Int length;
+    Int twice_area; // Signed, since it depends on the orientation
+  };
+
+  // Walks the loop starting with the given heading. Returns nothing if the path does not
+  // lead back to the start.
+  [[nodiscard]] std::optional<loop> walk(heading h) const {
+    Int r = Int(start / stride);
+    Int c = Int(start % stride);
+
+    loop l{0, 0};
+    std::size_t pos = start;
+    while (true) {
+      // Shoelace formula, simplified for unit steps:
+      // https://en.wikipedia.org/wiki/Shoelace_formula#Shoelace_formula
+      switch (h) {
+      case N:
+        l.twice_area += c;
+        --r;
+        break;
+      case S:
+        l.twice_area -= c;
+        ++r;
+        break;
+      case E:
+        l.twice_area += r;
+        ++c;
+        break;
+      case W:
+        l.twice_area -= r;
+        --c;
+        break;
+      }
+
+      ++l.length;
+      pos += offsets[h];
+      if (pos >= map.size()) {
+        return {};
+      }
+
+      const char cell = map[pos];
+      if (cell == 'S') {
+        return l;
+      }
+
+      const auto next = turns[std::uint8_t(cell)][h];
+      if (next == unknown) {
+        throw std::runtime_error(std::format("unexpected cell with value {}", cell));
+      }
+      if (next == blocked) {
+        return {};
+      }
+      h = heading(next);
     }
   }
 
-  // East side
-  if (std::size_t(start.c + 1) != map.ncols()) {
-    if (update_heading(map, {start.r, start.c + 1}, E).has_value()) {
-      possible_headings.push_back(E);
+private:
+  std::string_view map;
+  std::size_t stride;
+  std::size_t start;
+  std::array<std::size_t, 4> offsets; // Negative offsets rely on unsigned wrap-around
+};
+
+heading find_start_direction(walker const& w) {
+  std::size_t count = 0;
+  heading first = N;
+
+  for (auto h : headings) {
+    if (w.can_start(h)) {
+      first = count == 0 ? h : first;
+      ++count;
     }
   }
 
-  switch (possible_headings.size()) {
+  switch (count) {
   case 0:
     throw std::runtime_error("No possible heading from start point");
   case 1:
@@ -159,82 +169,38 @@ heading find_start_direction(xmas::views::text_matrix map, coords start) {
     xlog::warning("Multiple possible loops");
   }
 
-  return possible_headings.front();
-}
-
-Int compute_perimeter(std::vector<coords> const& vertices) {
-  return std::transform_reduce(std::execution::par_unseq, vertices.cbegin(), vertices.cend() - 1,
-    vertices.cbegin() + 1, 0, std::plus<Int>{},
-    [](coords const& u, coords const& v) { return std::abs(u.r - v.r) + std::abs(u.c - v.c); });
-}
-
-// Shoelace formula to find the (maybe non-integer) area, so 2*area is returned.
-// https://en.wikipedia.org/wiki/Shoelace_formula#Shoelace_formula
-Int compute_double_area(std::vector<coords> const& vertices) {
-  Int twice_area = std::transform_reduce(std::execution::par_unseq, vertices.begin(),
-    vertices.end() - 1, vertices.begin() + 1, Int{0}, std::plus<Int>{},
-    [](coords const& u1, coords const& u2) { return u1.r * u2.c - u1.c * u2.r; });
-
-  // Shoelace formula returns the signed area: the sign depends on wether the polygon is traversed
-  // clockwise or counterclockise. This is not something we care about here, so we remove the sign.
-  return std::abs(twice_area);
+  return first;
 }
 
-std::vector<coords> loop_path(xmas::views::text_matrix map, coords start, heading heading) {
-  assert(map.at(start) == 'S');
-  std::vector<coords> vertices{start};
-
-  auto pos = take_step(map, start, heading);
-  if (!pos.has_value()) {
-    xlog::warning("Cancelling path after 0 steps");
-    return {};
-  }
-
-  while (true) {
-    auto new_heading = update_heading(map, *pos, heading);
-    if (!new_heading.has_value()) {
-      break;
-    }
-
-    if (*new_heading != heading) {
-      heading = *new_heading;
-      vertices.push_back(*pos);
-    }
-
-    pos = take_step(map, *pos, heading);
-    if (!pos.has_value()) {
-      return {}; // Bad path
-    }
+walker::loop walk_loop(std::string_view input) {
+  const auto start = input.find('S');
+  if (start == std::string_view::npos) {
+    throw std::runtime_error("No start point");
   }
 
-  if (map.at(*pos) != 'S') {
-    // Bad path
-    return {};
+  const walker w(input, start);
+  const auto l = w.walk(find_start_direction(w));
+  if (!l.has_value()) {
+    xlog::warning("Path from start does not close a loop");
+    return {0, 0};
   }
 
-  vertices.push_back(start);
-
-  return vertices;
+  xlog::debug("Loop has length {} and twice the area {}", l->length, l->twice_area);
+  return *l;
 }
 
-Int loop_perimeter(xmas::views::text_matrix map, coords start, heading heading) {
-  auto vertices = loop_path(map, start, heading);
-  if (vertices.empty()) {
-    return 0; // Bad path
-  }
+}
 
-  return compute_perimeter(vertices);
+std::uint64_t Day10::part1() {
+  const auto loop = walk_loop(this->input);
+  return static_cast<std::uint64_t>(loop.length / 2);
 }
 
-Int loop_enclosed_area(xmas::views::text_matrix map, coords start, heading heading) {
-  auto vertices = loop_path(map, start, heading);
-  if (vertices.empty()) {
+std::uint64_t Day10::part2() {
+  const auto loop = walk_loop(this->input);
+  if (loop.length == 0) {
     return 0; // Bad path
   }
-  vertices.push_back(vertices.front());
-
-  Int twice_area = compute_double_area(vertices);
-  Int perimeter = compute_perimeter(vertices);
 
   // Pick's theorem
   // A = i + b/2 - 1
@@ -243,36 +209,9 @@ Int loop_enclosed_area(xmas::views::text_matrix map, coords start, heading headi
   // b is the count of boundary points. We can re-arrange it to:
   //
   // i = (2A - b)/2 + 1
-  return (twice_area - perimeter) / 2 + 1;
-}
-
-}
-
-std::uint64_t Day10::part1() {
-  xmas::views::text_matrix lines(this->input);
-
-  auto p = std::ranges::find(this->input, 'S') - this->input.begin();
-  coords S{
-    .r = Int(p) / Int(lines.ncols() + 1), // +1 for the \n
-    .c = Int(p) % Int(lines.ncols() + 1),
-  };
-
-  auto heading = find_start_direction(lines, S);
-
-  Int perimeter = loop_perimeter(lines, S, heading);
-  return static_cast<std::uint64_t>(perimeter / 2);
-}
-
-std::uint64_t Day10::part2() {
-  xmas::views::text_matrix lines(this->input);
-
-  auto p = std::ranges::find(this->input, 'S') - this->input.begin();
-  coords S{
-    .r = Int(p) / Int(lines.ncols() + 1), // +1 for the \n
-    .c = Int(p) % Int(lines.ncols() + 1),
-  };
-
-  auto heading = find_start_direction(lines, S);
-  Int enclosed_area = loop_enclosed_area(lines, S, heading);
-  return static_cast<std::uint64_t>(enclosed_area);
+  //
+  // The sign of the area depends on whether the loop is traversed clockwise or
+  // counterclockwise. This is not something we care about here, so we remove it.
+  const Int twice_area = std::abs(loop.twice_area);
+  return static_cast<std::uint64_t>((twice_area - loop.length) / 2 + 1);
 }
@@ -3,13 +3,14 @@
 #include "xmaslib/functional/functional.hpp"
 #include "xmaslib/iota/iota.hpp"
 #include "xmaslib/lazy_string/lazy_string.hpp"
-#include "xmaslib/line_iterator/line_iterator.hpp"
+#include "xmaslib/line_index/line_index.hpp"
 #include "xmaslib/log/log.hpp"
 #include "xmaslib/lru/lru.hpp"
 #include "xmaslib/parsing/parsing.hpp"
 #include "xmaslib/view/view.hpp"
 
 #include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -33,11 +34,20 @@ enum class cell : char {
   empty = '.'
 };
 
+// Malformed lines are reported before the lines are processed in parallel, because an
+// exception that escapes a parallel algorithm terminates the program
+void validate(xmas::views::line_index const& in) {
+  for (std::string_view line : in) {
+    if (std::ranges::find(line, ' ') == line.end()) {
+      throw std::runtime_error(std::format("Line '{}' has no separator", line));
+    }
+  }
+}
+
+// The line must have been validated
 auto parse_line(std::string_view line) {
   auto separator = std::ranges::find(line, ' ');
-  if (separator == line.end()) {
-    throw std::runtime_error(std::format("Line '%s' has no separator", line));
-  }
+  assert(separator != line.end());
 
   // Cheeky fast copy (only works because cells are a typedef'd char)
   auto const size = static_cast<std::size_t>(separator - line.begin());
@@ -367,14 +377,16 @@ std::uint64_t process_line(std::string_view line) {
 } // namespace
 
 std::uint64_t Day12::part1() {
-  auto in = xmas::views::linewise(this->input);
+  const xmas::views::line_index in(this->input);
+  validate(in);
 
   return std::transform_reduce(std::execution::par_unseq, in.cbegin(), in.cend(), std::uint64_t(0u),
     std::plus<std::uint64_t>{}, process_line<false>);
 }
 
 std::uint64_t Day12::part2() {
-  auto in = xmas::views::linewise(this->input);
+  const xmas::views::line_index in(this->input);
+  validate(in);
 
   return std::transform_reduce(std::execution::par_unseq, in.cbegin(), in.cend(), std::uint64_t(0u),
     std::plus<std::uint64_t>{}, process_line<true>);
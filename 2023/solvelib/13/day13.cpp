@@ -1,21 +1,18 @@
 #include "day13.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <execution>
 #include <functional>
 #include <numeric>
-#include <string>
 #include <string_view>
 #include <vector>
 
-#include "xmaslib/functional/functional.hpp"
-#include "xmaslib/line_iterator/line_iterator.hpp"
 #include "xmaslib/log/log.hpp"
-#include "xmaslib/stride/stride.hpp"
-#include "xmaslib/view/view.hpp"
 
 namespace {
 
@@ -46,157 +43,132 @@ std::pair<std::size_t, std::size_t> block_dimensions(std::string_view input) {
   return std::make_pair(nrows, ncols);
 }
 
-template <typename Iterator>
-void check_line_symmetry(
-  std::vector<bool>& potential_axes, Iterator line_begin, Iterator line_end) {
-  assert(line_begin < line_end);
-  assert(potential_axes.size() == static_cast<std::size_t>(line_end - line_begin));
-
-  auto v = xmas::view{line_begin, line_end};
-
-  potential_axes[0] = false;
-  for (std::size_t i = 1; i < potential_axes.size(); ++i) {
-    if (!potential_axes[i]) {
-      continue;
-    }
-    // Example: v=abccbaxyz, i=3
-    auto left = v.take(i);            // abc
-    auto right = v.drop(i).reverse(); // zyxabc
-
-    auto shortest = std::min(left.size(), right.size()); // 3
-
-    left.pop_front(left.size() - shortest);   // abc
-    right.pop_front(right.size() - shortest); // abc
-
-    auto it = std::mismatch(left.begin(), left.end(), right.begin());
-    if (it.first != left.end()) {
-      potential_axes[i] = false;
+// A block where every row and column is encoded as a bitmask (bit set for '#').
+// Comparing two lines is then a single XOR, and the number of differing cells
+// is its popcount.
+struct bitmask_block {
+  static constexpr std::size_t max_size = 64;
+
+  std::array<std::uint64_t, max_size> rows{};
+  std::array<std::uint64_t, max_size> cols{};
+  std::size_t nrows;
+  std::size_t ncols;
+
+  // The block must be at most max_size cells in either direction
+  explicit bitmask_block(std::string_view block) {
+    const auto [n, width] = block_dimensions(block);
+    nrows = n;
+    ncols = width - 1; // -1 to skip the trailing endline
+    assert(nrows <= max_size && ncols <= max_size);
+
+    std::size_t i = 0, j = 0;
+    for (char ch : block.substr(0, nrows * width)) {
+      if (ch == '\n') {
+        ++i;
+        j = 0;
+        continue;
+      }
+      const std::uint64_t set = ch == '#' ? 1 : 0;
+      rows[i] |= set << j;
+      cols[j] |= set << i;
+      ++j;
     }
   }
-}
-
-std::vector<std::size_t> check_block_horizontal_symmetries(
-  std::string_view block, std::size_t nrows, std::size_t ncols) {
-  const std::size_t width = ncols - 1; // -1 to skip the trailing endline
-  std::vector<bool> potential_axes(width, true);
-
-  for (std::size_t row = 0; row < nrows; ++row) {
-    auto begin = block.begin() + static_cast<std::ptrdiff_t>(row * ncols);
-    auto end = begin + static_cast<std::ptrdiff_t>(width);
 
-    check_line_symmetry(potential_axes, begin, end);
+  [[nodiscard]] static int distance(std::uint64_t l, std::uint64_t r) noexcept {
+    return std::popcount(l ^ r);
   }
-
-  std::vector<std::size_t> symmetries;
-  for (std::size_t i = 0; i < potential_axes.size(); ++i) {
-    if (potential_axes[i]) {
-      symmetries.push_back(i);
+};
+
+// find_axis returns the number of lines before the first axis of symmetry that has
+// exactly `smudges` mismatching cells across it. Returns 0 if there is none.
+// distance(i, j) is the number of mismatching cells between lines i and j.
+template <typename Distance>
+std::size_t find_axis(std::size_t nlines, int smudges, Distance distance) {
+  for (std::size_t axis = 1; axis < nlines; ++axis) {
+    const std::size_t reach = std::min(axis, nlines - axis);
+
+    int mismatches = 0;
+    for (std::size_t k = 0; k < reach && mismatches <= smudges; ++k) {
+      mismatches += distance(axis - 1 - k, axis + k);
     }
-  }
-  return symmetries;
-}
-
-std::vector<std::size_t> check_block_vertical_symmetries(
-  std::string_view block, std::size_t nrows, std::size_t ncols) {
-  std::vector<bool> potential_axes(nrows, true);
-
-  for (std::size_t col = 0; col < ncols; ++col) {
-    // We transpose the block by having a view with an iterator
-    // where ++it means jump to next row.
-    auto begin = block.begin() + static_cast<std::ptrdiff_t>(col);
-    auto end = begin + static_cast<std::ptrdiff_t>(nrows * ncols);
-    auto v = xmas::views::strided(begin, end, ncols);
 
-    check_line_symmetry(potential_axes, v.begin(), v.end());
-  }
-
-  std::vector<std::size_t> symmetries;
-  for (std::size_t i = 0; i < potential_axes.size(); ++i) {
-    if (potential_axes[i]) {
-      symmetries.push_back(i);
+    if (mismatches == smudges) {
+      return axis;
     }
   }
-  return symmetries;
+  return 0;
 }
 
-std::pair<std::uint64_t, std::uint64_t> solve_block(
-  std::string_view block, std::size_t nrows, std::size_t ncols) {
-  auto h = check_block_horizontal_symmetries(block, nrows, ncols);
-  if (h.size() != 0) {
-    return {h.front(), 0};
+// find_symmetry returns the score of a block, given the distances between its columns and
+// between its rows
+template <typename ColDistance, typename RowDistance>
+std::uint64_t find_symmetry(std::size_t nrows, std::size_t ncols, int smudges,
+  ColDistance col_distance, RowDistance row_distance) {
+  // Symmetric columns are found by comparing whole columns
+  if (auto c = find_axis(ncols, smudges, col_distance); c != 0) {
+    return c;
   }
 
-  auto v = check_block_vertical_symmetries(block, nrows, ncols);
-  if (v.size() != 0) {
-    return {0, v.front()};
+  if (auto r = find_axis(nrows, smudges, row_distance); r != 0) {
+    return 100 * r;
   }
 
   xlog::warning("block with no possible symmetry");
-  return {0, 0};
+  return 0;
 }
 
-char flip(char c) {
-  if (c == '#')
-    return '.';
-  if (c == '.')
-    return '#';
-  return c;
-}
+std::uint64_t solve_block(std::string_view block, int smudges) {
+  const auto [nrows, width] = block_dimensions(block);
+  const auto ncols = width - 1; // -1 to skip the trailing endline
 
-} // namespace
+  if (nrows <= bitmask_block::max_size && ncols <= bitmask_block::max_size) {
+    const bitmask_block b(block);
+    return find_symmetry(
+      nrows, ncols, smudges,
+      [&b](std::size_t l, std::size_t r) { return bitmask_block::distance(b.cols[l], b.cols[r]); },
+      [&b](std::size_t l, std::size_t r) { return bitmask_block::distance(b.rows[l], b.rows[r]); });
+  }
 
-std::uint64_t Day13::part1() {
-  auto block_begins = locate_block_begins(this->input);
+  // Blocks too large for a bitmask_block compare their lines cell by cell, in the text
+  const auto cell = [block, width](std::size_t i, std::size_t j) { return block[i * width + j]; };
+  return find_symmetry(
+    nrows, ncols, smudges,
+    [&](std::size_t l, std::size_t r) {
+      int d = 0;
+      for (std::size_t i = 0; i < nrows; ++i) {
+        d += cell(i, l) != cell(i, r) ? 1 : 0;
+      }
+      return d;
+    },
+    [&](std::size_t l, std::size_t r) {
+      int d = 0;
+      for (std::size_t j = 0; j < ncols; ++j) {
+        d += cell(l, j) != cell(r, j) ? 1 : 0;
+      }
+      return d;
+    });
+}
+
+std::uint64_t solve(std::string_view input, int smudges) {
+  auto block_begins = locate_block_begins(input);
 
   xlog::debug("Located {} blocks", block_begins.size() - 1);
 
   return std::transform_reduce(std::execution::par_unseq, block_begins.begin(),
     block_begins.end() - 1, block_begins.begin() + 1, std::uint64_t{0}, std::plus<std::uint64_t>{},
-    [](auto begin, auto begin_next) {
-      std::string_view block{begin, begin_next - 1};
-      const auto [nrows, ncols] = block_dimensions(block);
-      auto p1 = solve_block(block, nrows, ncols);
-      return p1.first + 100 * p1.second;
+    [smudges](auto begin, auto begin_next) {
+      return solve_block(std::string_view{begin, begin_next - 1}, smudges);
     });
 }
 
-std::uint64_t Day13::part2() {
-  auto block_begins = locate_block_begins(this->input);
-
-  xlog::debug("Located {} blocks", block_begins.size() - 1);
+} // namespace
 
-  return std::transform_reduce(std::execution::par_unseq, block_begins.begin(),
-    block_begins.end() - 1, block_begins.begin() + 1, std::uint64_t{0}, std::plus<std::uint64_t>{},
-    [](auto begin, auto begin_next) -> std::uint64_t {
-      // Blocks are relatively small (smaller than 20x20) so we can
-      // brute-force it
-      std::string block{begin, begin_next - 1};
-      const auto [nrows, ncols] = block_dimensions(block);
-      auto part1 = solve_block(block, nrows, ncols);
-
-      for (char& c : block) {
-        if (c == '\n') {
-          continue;
-        }
-
-        c = flip(c);
-
-        auto sym = check_block_horizontal_symmetries(block, nrows, ncols);
-        auto it = std::ranges::find_if_not(sym, xmas::equals(part1.first));
-        if (it != sym.end()) {
-          return *it;
-        }
-
-        sym = check_block_vertical_symmetries(block, nrows, ncols);
-        it = std::ranges::find_if_not(sym, xmas::equals(part1.second));
-        if (it != sym.end()) {
-          return 100 * (*it);
-        }
-
-        c = flip(c);
-      }
+std::uint64_t Day13::part1() {
+  return solve(this->input, 0);
+}
 
-      xlog::warning("block with no possible symmetry");
-      return 0;
-    });
+std::uint64_t Day13::part2() {
+  // The smudge is the single cell that mismatches across the new axis
+  return solve(this->input, 1);
 }
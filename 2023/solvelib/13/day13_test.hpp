@@ -22,6 +22,12 @@ TEST_CASE("Day 13") {
     REQUIRE_EQ(solution.part1(), 405);
   }
 
+  SUBCASE("Part 1, blocks larger than 64") {
+    solution.set_input("./data/13/large1.txt");
+    solution.load();
+    REQUIRE_EQ(solution.part1(), 5040);
+  }
+
   SUBCASE("Part 2, test 1") {
     solution.set_input("./data/13/test1.txt");
     solution.load();
@@ -40,6 +46,12 @@ TEST_CASE("Day 13") {
     REQUIRE_EQ(solution.part2(), 400);
   }
 
+  SUBCASE("Part 2, blocks larger than 64") {
+    solution.set_input("./data/13/large2.txt");
+    solution.load();
+    REQUIRE_EQ(solution.part2(), 5040);
+  }
+
   SUBCASE("Real data") {
     solution.set_input("./data/13/input.txt");
     solution.load();
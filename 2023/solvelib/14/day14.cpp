@@ -5,11 +5,10 @@
 #include <execution>
 #include <functional>
 #include <numeric>
-#include <stdexcept>
+#include <string>
 
+#include "xmaslib/cycle/cycle.hpp"
 #include "xmaslib/iota/iota.hpp"
-#include "xmaslib/log/log.hpp"
-#include "xmaslib/lru/lru.hpp"
 #include "xmaslib/matrix/text_matrix.hpp"
 
 std::uint64_t Day14::part1() {
@@ -93,46 +92,12 @@ std::uint64_t Day14::part2() {
   auto raw{input};
   constexpr std::size_t N = 1000000000;
 
+  // The rocks settle into a loop after a few spin cycles, so most of them can be skipped.
+  // The grid is its own snapshot: comparing it is cheaper than hashing it.
   xmas::views::text_matrix matrix(raw);
-  xmas::lru_cache<std::uint64_t, std::size_t> history(128);
-  //                                                  ^^^
-  // This number needs to be larger that the cycle we're trying to capture.
-
-  std::size_t cycle_size = 0;
-
-  std::size_t i = 1;
-  // Doing at most 1e6 iterations before giving up
-  for (; i < 1'000'000; ++i) {
-    loop_the_loop(matrix);
-
-    auto hash = std::hash<std::string>{}(raw);
-    xlog::debug("Iteration {} -> {}", i, hash);
-
-    auto opt = history.get(hash);
-    if (!opt.has_value()) {
-      history.set(hash, i);
-      continue;
-    }
-
-    cycle_size = i - *opt;
-    break;
-  }
-
-  if (cycle_size == 0) {
-    throw std::runtime_error("No cycle detected");
-  }
-  xlog::debug("Detected a cycle after {}  iterations", i);
-  xlog::debug("The cycle is {} iterations long", cycle_size);
-
-  // Fast-forward cycle
-  std::size_t remaining_cycles = (N - i) / cycle_size;
-  i += remaining_cycles * cycle_size;
-
-  xlog::debug("Fast-forwarding to iteration {}", i);
-
-  for (; i < N; ++i) {
-    loop_the_loop(matrix);
-  }
+  xmas::cycle::fast_forward(
+    raw, N, [&matrix](std::string&) { loop_the_loop(matrix); },
+    [](std::string const& grid) -> std::string const& { return grid; });
 
   return compute_load(matrix);
-}
\ No newline at end of file
+}
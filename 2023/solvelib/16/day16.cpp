@@ -8,10 +8,12 @@
 #include <vector>
 
 #include "day16.hpp"
+#include "xmaslib/arena/arena.hpp"
 #include "xmaslib/functional/functional.hpp"
 #include "xmaslib/iota/iota.hpp"
 #include "xmaslib/lazy_string/lazy_string.hpp"
 #include "xmaslib/log/log.hpp"
+#include "xmaslib/matrix/padded_grid.hpp"
 #include "xmaslib/matrix/text_matrix.hpp"
 
 namespace {
@@ -53,41 +55,36 @@ struct cell {
   }
 };
 
+using grid = xmas::padded_grid<char>;
+
+// Marks the cells outside the map
+constexpr char border = ' ';
+
+grid::direction to_direction(heading h) {
+  switch (h) {
+  case heading::left:
+    return grid::left;
+  case heading::right:
+    return grid::right;
+  case heading::up:
+    return grid::up;
+  case heading::down:
+    return grid::down;
+  default:
+    throw std::runtime_error("Beam heading nowhere");
+  }
+}
+
 struct beam {
   heading towards;
-  std::ptrdiff_t row;
-  std::ptrdiff_t col;
+  std::size_t pos; // Flat index in the padded map
 
   bool operator==(beam const& other) const {
-    return row == other.row && col == other.col && towards == other.towards;
+    return pos == other.pos && towards == other.towards;
   }
 
-  std::size_t srow() const {
-    assert(row >= 0);
-    return static_cast<std::size_t>(row);
-  }
-  std::size_t scol() const {
-    assert(col >= 0);
-    return static_cast<std::size_t>(col);
-  }
-
-  void step() {
-    switch (towards) {
-    case heading::left:
-      --col;
-      break;
-    case heading::right:
-      ++col;
-      break;
-    case heading::up:
-      --row;
-      break;
-    case heading::down:
-      ++row;
-      break;
-    case heading::none:
-      throw std::runtime_error("Beam heading nowhere");
-    }
+  void step(grid const& map) {
+    pos = map.neighbour(pos, to_direction(towards));
   }
 
   orientation beam_orientation() {
@@ -109,13 +106,13 @@ struct beam {
     switch (beam_orientation()) {
     case orientation::vertical:
       return {
-        {.towards = heading::left,  .row = row, .col = col},
-        {.towards = heading::right, .row = row, .col = col}
+        {.towards = heading::left,  .pos = pos},
+        {.towards = heading::right, .pos = pos}
       };
     case orientation::horizontal:
       return {
-        {.towards = heading::up,   .row = row, .col = col},
-        {.towards = heading::down, .row = row, .col = col}
+        {.towards = heading::up,   .pos = pos},
+        {.towards = heading::down, .pos = pos}
       };
     default:
       assert(false);
@@ -123,17 +120,6 @@ struct beam {
     }
   }
 
-  bool off_limits(xmas::views::text_matrix const& map) {
-    if (row < 0 || col < 0) {
-      return true;
-    }
-    if (srow() >= map.nrows() || scol() >= map.ncols()) {
-      return true;
-    }
-
-    return false;
-  }
-
   bool beam_must_split(char pos) {
     auto o = splitter_orientation(pos);
     if (o == orientation::none) {
@@ -182,12 +168,11 @@ struct beam {
     return heading::none;
   }
 
-  std::string print_state(xmas::views::text_matrix const& map,
-    std::vector<std::vector<cell>>& visited) const {
+  std::string print_state(grid const& map, xmas::padded_grid<cell> const& visited) const {
     std::stringstream ss;
     for (std::size_t i = 0; i < map.nrows(); ++i) {
       for (std::size_t j = 0; j < map.ncols(); ++j) {
-        if (i == srow() && j == scol()) {
+        if (map.index(i, j) == pos) {
           ss << "X";
           continue;
         }
@@ -195,38 +180,38 @@ struct beam {
           ss << x;
           continue;
         }
-        ss << int(visited[i][j].visited);
+        ss << int(visited.at(i, j).visited);
       }
       ss << '\n';
     }
     return ss.str();
   }
 
-  std::vector<beam> advance(xmas::views::text_matrix const& map,
-    std::vector<std::vector<cell>>& visited) {
-    std::vector<beam> new_beams;
+  // advance follows the beam until it leaves the map or loops. Beams split off on the way
+  // are appended to new_beams.
+  void advance(
+    grid const& map, xmas::padded_grid<cell>& visited, xmas::pmr::vector<beam>& new_beams) {
     while (true) {
-      step();
+      step(map);
       // xlog::debug("\nSTEP\n{}", print_state(map, visited));
 
-      if (off_limits(map)) {
-        break;
+      char ch = map[pos];
+      if (ch == border) {
+        return;
       }
 
-      auto& cell = visited[srow()][scol()];
+      auto& cell = visited[pos];
       if (cell.history_contains(towards)) {
-        break;
+        return;
       }
       cell.set_history(towards);
 
-      char pos = map.at(srow(), scol());
-
-      if (auto d = reflection(pos); d != heading::none) {
+      if (auto d = reflection(ch); d != heading::none) {
         towards = d;
         continue;
       }
 
-      if (!beam_must_split(pos)) {
+      if (!beam_must_split(ch)) {
         continue;
       }
 
@@ -235,37 +220,39 @@ struct beam {
       *this = beam1;
       new_beams.push_back(beam2);
     }
-
-    return new_beams;
   }
 };
+
+// entering returns a beam that is about to enter the map at (row, col)
+beam entering(grid const& map, heading towards, std::size_t row, std::size_t col) {
+  const auto pos = map.index(row, col);
+  return {.towards = towards, .pos = map.neighbour(pos, grid::opposite(to_direction(towards)))};
+}
+
 } // namespace
 
 namespace {
 
-std::uint64_t solve(xmas::views::text_matrix const& map, beam init_beam) {
-  std::vector visited(map.nrows(), std::vector<cell>(map.ncols(), cell{}));
-  std::vector<beam> beams{init_beam};
+std::uint64_t solve(grid const& map, beam init_beam, std::pmr::memory_resource* scratch) {
+  xmas::padded_grid<cell> visited(map.nrows(), map.ncols(), cell{});
+  xmas::pmr::vector<beam> beams({init_beam}, scratch);
+  xmas::pmr::vector<beam> curr(scratch);
 
   while (!beams.empty()) {
-    auto curr = std::move(beams);
-    beams = {};
-    beams.reserve(2 * curr.size());
+    std::swap(curr, beams);
+    beams.clear();
 
     for (auto b : curr) {
-      auto new_beams = b.advance(map, visited);
-      for (auto& nb : new_beams) {
-        beams.push_back(nb);
-      }
+      b.advance(map, visited, beams);
     }
   }
 
-  auto x = std::transform_reduce(std::execution::unseq, visited.begin(), visited.end(),
-    std::uint64_t{0}, std::plus<std::uint64_t>{}, [](auto const& row) {
-      return std::transform_reduce(std::execution::unseq, row.begin(), row.end(), std::uint64_t{0},
-        std::plus<std::uint64_t>{}, [](cell c) { return int(c.visited) != 0u; });
-    });
+  auto x = std::transform_reduce(std::execution::unseq, visited.data().begin(),
+    visited.data().end(), std::uint64_t{0}, std::plus<std::uint64_t>{},
+    [](cell c) { return int(c.visited) != 0u; });
 
+  [[maybe_unused]] const auto [entry_row, entry_col] =
+    map.coords(map.neighbour(init_beam.pos, to_direction(init_beam.towards)));
   xlog::debug("Running {} from ({:>3},{:>3}) results in {:>3} visited cells",
     xmas::lazy_string([&]() -> std::string {
       switch (init_beam.towards) {
@@ -281,7 +268,7 @@ std::uint64_t solve(xmas::views::text_matrix const& map, beam init_beam) {
         return std::format("{:>4}?", int(init_beam.towards));
       }
     }),
-    init_beam.row, init_beam.col, x);
+    entry_row, entry_col, x);
 
   return x;
 }
@@ -289,33 +276,31 @@ std::uint64_t solve(xmas::views::text_matrix const& map, beam init_beam) {
 } // namespace
 
 std::uint64_t Day16::part1() {
-  xmas::views::text_matrix map(this->input);
-  return solve(map, {.towards = heading::right, .row = 0, .col = -1});
+  const grid map(xmas::views::text_matrix(this->input), border);
+  return solve(map, entering(map, heading::right, 0, 0), scratch.resource());
 }
 
 std::uint64_t Day16::part2() {
-  xmas::views::text_matrix map(this->input);
+  const grid map(xmas::views::text_matrix(this->input), border);
 
   // Iterate over all rows, entering from left and right every iteration
   xmas::views::iota<std::size_t> rows(map.nrows());
   auto h = std::transform_reduce(std::execution::par_unseq, rows.begin(), rows.end(),
-    std::uint64_t{0}, xmas::max<std::uint64_t>{}, [&map](std::size_t row) {
-      auto from_left =
-        solve(map, {.towards = heading::right, .row = std::ptrdiff_t(row), .col = -1});
-      auto from_right = solve(map,
-        {.towards = heading::left, .row = std::ptrdiff_t(row), .col = std::ptrdiff_t(map.ncols())});
+    std::uint64_t{0}, xmas::max<std::uint64_t>{}, [this, &map](std::size_t row) {
+      auto* mem = scratch.resource();
+      auto from_left = solve(map, entering(map, heading::right, row, 0), mem);
+      auto from_right = solve(map, entering(map, heading::left, row, map.ncols() - 1), mem);
       return std::max(from_left, from_right);
     });
 
   // Iterate over all columns, entering from above and below every iteration
   xmas::views::iota<std::size_t> cols(map.ncols());
   auto v = std::transform_reduce(std::execution::par_unseq, cols.begin(), cols.end(),
-    std::uint64_t{0}, xmas::max<std::uint64_t>{}, [&map](std::size_t col) {
-      auto from_above =
-        solve(map, {.towards = heading::down, .row = -1, .col = std::ptrdiff_t(col)});
-      auto from_below = solve(map,
-        {.towards = heading::up, .row = std::ptrdiff_t(map.nrows()), .col = std::ptrdiff_t(col)});
+    std::uint64_t{0}, xmas::max<std::uint64_t>{}, [this, &map](std::size_t col) {
+      auto* mem = scratch.resource();
+      auto from_above = solve(map, entering(map, heading::down, 0, col), mem);
+      auto from_below = solve(map, entering(map, heading::up, map.nrows() - 1, col), mem);
       return std::max(from_above, from_below);
     });
   return std::max(h, v);
-}
\ No newline at end of file
+}
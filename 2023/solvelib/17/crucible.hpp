@@ -0,0 +1,130 @@
+#pragma once
+
+#include "xmaslib/graph/graph.hpp"
+#include "xmaslib/graph/search.hpp"
+#include "xmaslib/matrix/text_matrix.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace crucible {
+
+using heat_t = std::uint32_t;
+using graph = xmas::graph<heat_t>;
+using node_id = graph::node_id;
+
+// The axis along which the crucible arrived at a block. It must leave along the other one.
+enum axis : std::uint8_t {
+  horizontal = 0,
+  vertical = 1,
+};
+
+/*
+city is the graph of the moves of the crucible.
+
+Every node is a block together with the axis along which the crucible arrived at it. Every
+edge is a turn followed by a straight run of min_steps to max_steps blocks, weighted by the
+heat lost along the run. Intermediate blocks of a run are not nodes, so the limits on the
+length of runs are built into the edges.
+*/
+struct city {
+  graph moves;
+  std::size_t nrows;
+  std::size_t ncols;
+
+  [[nodiscard]] node_id node(std::size_t row, std::size_t col, axis a) const noexcept {
+    return static_cast<node_id>(2 * (row * ncols + col) + a);
+  }
+
+  [[nodiscard]] std::array<node_id, 2> sources() const noexcept {
+    return {node(0, 0, horizontal), node(0, 0, vertical)};
+  }
+
+  [[nodiscard]] bool is_target(node_id n) const noexcept {
+    return n / 2 == nrows * ncols - 1;
+  }
+
+  // Manhattan distance to the bottom-right block. Every block loses at least one unit of
+  // heat, so this never overestimates the heat lost on the way there.
+  [[nodiscard]] heat_t distance_to_target(node_id n) const noexcept {
+    const std::size_t block = n / 2;
+    return static_cast<heat_t>((nrows - 1 - block / ncols) + (ncols - 1 - block % ncols));
+  }
+};
+
+inline city build_city(
+  xmas::views::text_matrix const& map, std::size_t min_steps, std::size_t max_steps) {
+  city c{.moves = {}, .nrows = map.nrows(), .ncols = map.ncols()};
+  if (c.nrows == 0 || c.ncols == 0) {
+    throw std::runtime_error("Empty map");
+  }
+
+  std::vector<graph::edge> edges;
+  edges.reserve(4 * c.nrows * c.ncols * (max_steps - min_steps + 1));
+
+  // Adds the runs that start at (r, c) and advance by (dr, dc) on every step
+  const auto add_runs = [&](std::size_t r, std::size_t col, int dr, int dc, axis arrival) {
+    const node_id from = c.node(r, col, arrival == horizontal ? vertical : horizontal);
+    heat_t heat = 0;
+    for (std::size_t k = 1; k <= max_steps; ++k) {
+      r += static_cast<std::size_t>(dr);
+      col += static_cast<std::size_t>(dc);
+      if (r >= c.nrows || col >= c.ncols) { // Negative coordinates wrap around
+        return;
+      }
+      const char block = map.at(r, col);
+      if (block < '1' || block > '9') {
+        throw std::runtime_error(std::format("Invalid block '{}' at ({}, {})", block, r, col));
+      }
+      heat += static_cast<heat_t>(block - '0');
+      if (k >= min_steps) {
+        edges.push_back({from, c.node(r, col, arrival), heat});
+      }
+    }
+  };
+
+  for (std::size_t r = 0; r < c.nrows; ++r) {
+    for (std::size_t col = 0; col < c.ncols; ++col) {
+      add_runs(r, col, -1, 0, vertical);
+      add_runs(r, col, +1, 0, vertical);
+      add_runs(r, col, 0, -1, horizontal);
+      add_runs(r, col, 0, +1, horizontal);
+    }
+  }
+
+  c.moves = graph(2 * c.nrows * c.ncols, edges);
+  return c;
+}
+
+// Finds the least heat that can be lost on the way to the bottom-right block. The search
+// is guided by the distance to the target with A* if `guided`, or runs Dijkstra otherwise.
+template <bool guided, typename Queue>
+heat_t least_heat_loss(city const& c, xmas::path_finder<heat_t, Queue>& finder) {
+  std::optional<heat_t> best;
+  const auto visit = [&](node_id n, heat_t heat) {
+    if (!c.is_target(n)) {
+      return xmas::search_action::proceed;
+    }
+    best = heat;
+    return xmas::search_action::stop;
+  };
+
+  const auto sources = c.sources();
+  if constexpr (guided) {
+    finder.astar(c.moves, sources, [&](node_id n) { return c.distance_to_target(n); }, visit);
+  } else {
+    finder.dijkstra(c.moves, sources, visit);
+  }
+
+  if (!best.has_value()) {
+    throw std::runtime_error("Could not find a path to the exit");
+  }
+  return *best;
+}
+
+} // namespace crucible
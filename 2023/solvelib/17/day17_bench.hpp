@@ -0,0 +1,88 @@
+#pragma once
+
+#include "bench/bench.hpp"
+
+#include "crucible.hpp"
+
+#include "xmaslib/graph/priority_queue.hpp"
+#include "xmaslib/graph/search.hpp"
+#include "xmaslib/matrix/text_matrix.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace day17_bench {
+
+// Loads the puzzle input, or generates a map of the same size if it is not available
+inline std::string load_map() {
+  if (std::ifstream f("./data/17/input.txt"); f) {
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return std::move(ss).str();
+  }
+
+  xlog::warning("day17_queues: input not found, using a random map");
+  constexpr std::size_t n = 141;
+  std::string text;
+  std::uint64_t state = 42;
+  for (std::size_t r = 0; r < n; ++r) {
+    for (std::size_t c = 0; c < n; ++c) {
+      state = state * 6364136223846793005u + 1442695040888963407u;
+      text.push_back(static_cast<char>('1' + (state >> 33) % 9));
+    }
+    text.push_back('\n');
+  }
+  return text;
+}
+
+using crucible::heat_t;
+using crucible::node_id;
+
+// Times one kind of search, after checking that it finds the expected heat loss
+template <bool guided, typename Queue>
+void compare(crucible::city const& city, std::string_view variant, heat_t expected) {
+  xmas::path_finder<heat_t, Queue> finder;
+  if (auto got = crucible::least_heat_loss<guided>(city, finder); got != expected) {
+    xlog::error("day17_queues: {} found {} instead of {}", variant, got, expected);
+    return;
+  }
+
+  bench::report("day17_queues", variant, bench::run([&] {
+    bench::do_not_optimize(crucible::least_heat_loss<guided>(city, finder));
+  }));
+}
+
+inline const bench::registration registration("day17_queues", [] {
+  auto text = load_map();
+  const xmas::views::text_matrix map(text);
+
+  for (auto [part, min_steps, max_steps] : {std::tuple{1, 1, 3}, std::tuple{2, 4, 10}}) {
+    bench::report("day17_queues", std::format("build {}", part), bench::run([&] {
+      bench::do_not_optimize(crucible::build_city(map, min_steps, max_steps).moves.nedges());
+    }));
+
+    const auto city = crucible::build_city(map, min_steps, max_steps);
+
+    using binary = xmas::binary_heap<heat_t, node_id>;
+    using dary = xmas::dary_heap<heat_t, node_id, 4>;
+    using radix = xmas::radix_heap<heat_t, node_id>;
+
+    xmas::path_finder<heat_t, binary> reference;
+    const auto expected = crucible::least_heat_loss<false>(city, reference);
+
+    compare<false, binary>(city, std::format("binary {}", part), expected);
+    compare<false, dary>(city, std::format("4-ary {}", part), expected);
+    compare<false, radix>(city, std::format("radix {}", part), expected);
+    compare<true, binary>(city, std::format("A* binary {}", part), expected);
+    compare<true, radix>(city, std::format("A* radix {}", part), expected);
+  }
+});
+
+} // namespace day17_bench
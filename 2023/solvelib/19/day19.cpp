@@ -339,11 +339,13 @@ std::uint64_t Day19::part2() {
               }, worflow_in}
   };
 
+  // The batches swap their buffers, so that only the first few allocate
+  decltype(items) curr;
   std::uint64_t score = 0;
   while (!items.empty()) {
     xlog::debug("Executing batch of {} item ranges", items.size());
-    auto curr = std::move(items);
-    items = {};
+    std::swap(curr, items);
+    items.clear();
     for (auto const& [item_range, workflow_id] : curr) {
       if (workflow_id == rule::rejected) {
         continue;
@@ -1,5 +1,6 @@
 #include "day20.hpp"
 
+#include "xmaslib/arena/arena.hpp"
 #include "xmaslib/line_iterator/line_iterator.hpp"
 #include "xmaslib/log/log.hpp"
 #include "xmaslib/parsing/parsing.hpp"
@@ -230,16 +231,17 @@ struct pulse_info {
 
 // Pressing the button sends a low signal to module 0 and executes until there are no beams left
 // or until RX receives a pulse
-std::tuple<std::uint64_t, std::uint64_t> press_button(std::span<module> modules) {
-  std::vector<pulse_info> pulses;
+std::tuple<std::uint64_t, std::uint64_t> press_button(
+  std::span<module> modules, std::pmr::memory_resource* scratch) {
+  xmas::pmr::vector<pulse_info> pulses(scratch);
+  xmas::pmr::vector<pulse_info> batch(scratch);
   pulses.emplace_back(broadcast_id, broadcast_id, lo);
 
   std::uint64_t hi_count = 0;
   std::uint64_t lo_count = 1;
   while (!pulses.empty()) {
-    auto batch = std::move(pulses);
-    pulses = {};
-    pulses.reserve(batch.size());
+    std::swap(batch, pulses);
+    pulses.clear();
 
     for (auto const& [from, module_id, in_pulse] : batch) {
       auto out_pulse = modules[module_id].process_pulse(from, in_pulse);
@@ -282,7 +284,7 @@ std::uint64_t Day20::part1() {
   };
 
   for (info.iteration = 1; info.iteration <= N; ++info.iteration) {
-    const auto [lo_count_i, hi_count_i] = press_button(modules);
+    const auto [lo_count_i, hi_count_i] = press_button(modules, scratch.resource());
     info.lo_count += lo_count_i;
     info.hi_count += hi_count_i;
   }
@@ -1,7 +1,7 @@
 #include "day21.hpp"
 
 #include "xmaslib/log/log.hpp"
-#include "xmaslib/matrix/dense_matrix.hpp"
+#include "xmaslib/matrix/padded_grid.hpp"
 #include "xmaslib/matrix/text_matrix.hpp"
 #include "xmaslib/lazy_string/lazy_string.hpp"
 
@@ -22,73 +22,46 @@
 
 namespace {
 
-struct coords {
-  std::size_t row, col;
-};
-
-}
+using grid = xmas::padded_grid<char>;
+using distance_grid = xmas::padded_grid<std::size_t>;
 
-namespace {
-
-coords find_start(xmas::views::text_matrix map) {
+std::size_t find_start(grid const& map) {
   auto it = std::ranges::find(map.data(), 'S');
   if (it == map.data().end()) {
     throw std::runtime_error("Map contains no starting point");
   }
-
-  const auto delta = static_cast<std::size_t>(it - map.data().begin());
-  return {
-    delta / (map.ncols() + 1), // Counting endlines
-    delta % (map.ncols() + 1), // Counting endlines
-  };
+  return static_cast<std::size_t>(it - map.data().begin());
 }
 
 constexpr auto sentinel = std::numeric_limits<std::size_t>::max();
 
-void bfs(xmas::views::text_matrix map, xmas::dense_matrix<std::size_t>& distances, std::size_t d,
-  coords pos, std::back_insert_iterator<std::vector<coords>> enqueuer) {
-  if (distances[pos.row][pos.col] != sentinel) {
+// The border of the map is made of rocks, so no bounds checks are needed
+void bfs(grid const& map, distance_grid& distances, std::size_t d, std::size_t pos,
+  std::back_insert_iterator<std::vector<std::size_t>> enqueuer) {
+  if (distances[pos] != sentinel) {
     return;
   }
 
-  distances[pos.row][pos.col] = d;
+  distances[pos] = d;
 
-  if (pos.row != 0) {
-    coords c{pos.row - 1, pos.col};
-    if (map.at(c.row, c.col) != '#') {
-      *enqueuer = c;
-    }
-  }
-  if (pos.row + 1 < map.nrows()) {
-    coords c{pos.row + 1, pos.col};
-    if (map.at(c.row, c.col) != '#') {
-      *enqueuer = c;
-    }
-  }
-  if (pos.col != 0) {
-    coords c{pos.row, pos.col - 1};
-    if (map.at(c.row, c.col) != '#') {
-      *enqueuer = c;
-    }
-  }
-  if (pos.col + 1 < map.ncols()) {
-    coords c{pos.row, pos.col + 1};
-    if (map.at(c.row, c.col) != '#') {
-      *enqueuer = c;
+  for (auto dir : grid::directions) {
+    const auto next = map.neighbour(pos, dir);
+    if (map[next] != '#') {
+      *enqueuer = next;
     }
   }
 }
 
-[[maybe_unused]] auto fmt_map(
-  xmas::views::text_matrix map, xmas::dense_matrix<std::size_t>& distance) {
-  return xmas::lazy_string([map, &distance]() -> std::string {
+[[maybe_unused]] auto fmt_map(grid const& map, distance_grid const& distance) {
+  return xmas::lazy_string([&map, &distance]() -> std::string {
     std::stringstream ss;
     for (std::size_t i = 0; i < map.nrows(); ++i) {
       for (std::size_t j = 0; j < map.ncols(); ++j) {
         ss << [&]() {
-          if (distance[i][j] == sentinel)
+          const auto d = distance.at(i, j);
+          if (d == sentinel)
             return map.at(i, j);
-          if (distance[i][j] % 2 == 0)
+          if (d % 2 == 0)
             return 'E';
           return 'O';
         }();
@@ -100,8 +73,8 @@ void bfs(xmas::views::text_matrix map, xmas::dense_matrix<std::size_t>& distance
 }
 
 std::pair<std::size_t, std::size_t> count_parities(
-  xmas::views::text_matrix map, std::size_t nsteps, coords start) {
-  xmas::dense_matrix<std::size_t> distance(map.nrows(), map.ncols(), sentinel);
+  grid const& map, std::size_t nsteps, std::size_t start) {
+  distance_grid distance(map.nrows(), map.ncols(), sentinel, sentinel);
 
   std::vector queue{start};
   for (std::size_t s = 0; s <= nsteps; ++s) {
@@ -120,7 +93,7 @@ std::pair<std::size_t, std::size_t> count_parities(
   // xlog::debug("Map:\n{}\n", fmt_map(map, distance));
 
   return std::transform_reduce(
-    std::execution::par_unseq, distance.cdata().begin(), distance.cdata().end(),
+    std::execution::par_unseq, distance.data().begin(), distance.data().end(),
     std::pair<std::size_t, std::size_t>{0, 0},
     [](auto l, auto r) -> std::pair<std::size_t, std::size_t> {
       return {l.first + r.first, l.second + r.second};
@@ -139,9 +112,9 @@ std::pair<std::size_t, std::size_t> count_parities(
 }
 
 std::uint64_t Day21::part1_generalized(std::size_t nsteps) {
-  xmas::views::text_matrix map(this->input);
+  const grid map(xmas::views::text_matrix(this->input), '#');
   auto start = find_start(map);
-  xlog::debug("Start position is ({}, {})", start.row, start.col);
+  xlog::debug("Start position is ({}, {})", map.coords(start).first, map.coords(start).second);
 
   auto [even, odd] = count_parities(map, nsteps, start);
 
@@ -176,7 +149,7 @@ std::uint64_t Day21::part2_generalized(std::size_t steps) {
   /*
   Check out the README or nothing will make sense here.
   */
-  xmas::views::text_matrix map(this->input);
+  const grid map(xmas::views::text_matrix(this->input), '#');
 
   if (map.ncols() != map.nrows()) {
     throw std::runtime_error("This solution assumes square blocks");
@@ -197,23 +170,20 @@ std::uint64_t Day21::part2_generalized(std::size_t steps) {
 
   auto start = find_start(map);
   const std::size_t half_block = block_size / 2;
-  if (start.row != half_block) {
-    throw std::runtime_error("This solution assumes the start point is at the center");
-  }
-  if (start.col != half_block) {
+  if (start != map.index(half_block, half_block)) {
     throw std::runtime_error("This solution assumes the start point is at the center");
   }
 
-  std::array<coords, 9> pos;
-  pos[NW] = {0, 0};
-  pos[N] = {0, half_block};
-  pos[NE] = {0, block_size - 1};
-  pos[W] = {half_block, 0};
-  pos[C] = {half_block, half_block};
-  pos[E] = {half_block, block_size - 1};
-  pos[SW] = {block_size - 1, 0};
-  pos[S] = {block_size - 1, half_block};
-  pos[SE] = {block_size - 1, block_size - 1};
+  std::array<std::size_t, 9> pos;
+  pos[NW] = map.index(0, 0);
+  pos[N] = map.index(0, half_block);
+  pos[NE] = map.index(0, block_size - 1);
+  pos[W] = map.index(half_block, 0);
+  pos[C] = map.index(half_block, half_block);
+  pos[E] = map.index(half_block, block_size - 1);
+  pos[SW] = map.index(block_size - 1, 0);
+  pos[S] = map.index(block_size - 1, half_block);
+  pos[SE] = map.index(block_size - 1, block_size - 1);
 
   std::vector<std::pair<std::size_t, std::size_t>> purple;
   std::vector<std::pair<std::size_t, std::size_t>> orange;
@@ -1,8 +1,9 @@
 #include "day22.hpp"
 
+#include "xmaslib/arena/arena.hpp"
 #include "xmaslib/functional/functional.hpp"
 #include "xmaslib/matrix/dense_matrix.hpp"
-#include "xmaslib/line_iterator/line_iterator.hpp"
+#include "xmaslib/line_index/line_index.hpp"
 #include "xmaslib/parsing/parsing.hpp"
 #include "xmaslib/lazy_string/lazy_string.hpp"
 #include "xmaslib/log/log.hpp"
@@ -92,9 +93,9 @@ block parse_block(std::string_view line) {
 
 // Returns a list of blocks sorted by height (bottom to top)
 std::vector<block> parse(std::string_view input) {
-  xmas::views::linewise lines(input);
-  std::vector<block> blocks;
-  std::transform(lines.begin(), lines.end(), std::back_inserter(blocks), parse_block);
+  const xmas::views::line_index lines(input);
+  std::vector<block> blocks(lines.size());
+  std::transform(lines.begin(), lines.end(), blocks.begin(), parse_block);
 
   rng::sort(blocks, [](block const& l, block const& r) { return l.lower.z < r.lower.z; });
 
@@ -199,25 +200,28 @@ bool is_subset(auto const& contained, auto const& container) {
   return true;
 }
 
-std::size_t count_chain_reaction(std::span<const block> blocks, block_t root) {
-  std::set<block_t> upstream{root};
-  std::set<block_t> tip{root};
+std::size_t count_chain_reaction(
+  std::span<const block> blocks, block_t root, std::pmr::memory_resource* scratch) {
+  xmas::pmr::set<block_t> upstream({root}, scratch);
+  xmas::pmr::set<block_t> tip({root}, scratch);
+  xmas::pmr::set<block_t> candidates(scratch);
 
   while (!tip.empty()) {
-    std::set<block_t> candidates;
+    candidates.clear();
     rng::for_each(tip, [&](block_t id) {
       rng::copy(blocks[id].supporting, std::inserter(candidates, candidates.end()));
     });
 
     // clang-format off
     auto selected = candidates 
-      | v::transform([&](block_t id) { return blocks[id]; })
+      | v::transform([&](block_t id) -> block const& { return blocks[id]; })
       | v::filter([&](block const& b) { return is_subset(b.supported_by, upstream); }) 
       | v::transform([](block const& b) { return b.id; });
     // clang-format on
 
     upstream.insert(tip.begin(), tip.end());
-    tip = std::set(selected.begin(), selected.end());
+    tip.clear();
+    tip.insert(selected.begin(), selected.end());
   }
 
   return upstream.size() - 1;
@@ -231,5 +235,5 @@ std::uint64_t Day22::part2() {
 
   return std::transform_reduce(std::execution::par_unseq, blocks.begin(), blocks.end(),
     std::uint64_t{0}, std::plus<std::uint64_t>{},
-    [&](block const& b) { return count_chain_reaction(blocks, b.id); });
+    [&](block const& b) { return count_chain_reaction(blocks, b.id, scratch.resource()); });
 }
\ No newline at end of file
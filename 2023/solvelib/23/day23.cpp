@@ -1,5 +1,7 @@
 #include "day23.hpp"
 
+#include "xmaslib/cache/cache.hpp"
+#include "xmaslib/graph/graph.hpp"
 #include "xmaslib/log/log.hpp"
 #include "xmaslib/matrix/dense_matrix.hpp"
 #include "xmaslib/matrix/text_matrix.hpp"
@@ -265,9 +267,38 @@ public:
   }
 };
 
+// The search runs on a compact copy of the graph, with the edges of every node contiguous
+using csr_graph = xmas::graph<length_t>;
+
+// Adds every edge in reverse, so that slopes can be walked both ways
+void make_bidirectional(graph& g) {
+  for (auto const& n : g.nodes) {
+    for (auto [dest, len] : n.neigbours) {
+      g.add_edge(dest, n.id, len, false);
+    }
+  }
+}
+
+// Version of the layout of the input cache
+constexpr std::uint32_t cache_version = 1;
+
+std::vector<csr_graph::edge> edge_list(graph const& g) {
+  std::vector<csr_graph::edge> edges;
+  for (auto const& n : g.nodes) {
+    for (auto [to, len] : n.neigbours) {
+      edges.push_back({
+        .from = static_cast<csr_graph::node_id>(n.id),
+        .to = static_cast<csr_graph::node_id>(to),
+        .weight = len,
+      });
+    }
+  }
+  return edges;
+}
+
 // longest_path returns the longest path from node pos to node target, if there is one at all.
-std::optional<length_t> longest_path(
-  graph const& g, graph::node_id pos, graph::node_id target, visit_record visited = {}) {
+std::optional<length_t> longest_path(csr_graph const& g, csr_graph::node_id pos,
+  csr_graph::node_id target, visit_record visited = {}) {
   if (pos == target) {
     return {0};
   }
@@ -276,7 +307,7 @@ std::optional<length_t> longest_path(
 
   std::optional<length_t> best = {}; // The best path so far, if any
 
-  for (auto const& [neigh, distance] : g.nodes[pos].neigbours) {
+  for (auto const& [neigh, distance] : g.neighbours(pos)) {
     if (visited.get(neigh)) {
       continue;
     }
@@ -295,7 +326,20 @@ std::optional<length_t> longest_path(
 
 }
 
-std::uint64_t Day23::part1() {
+xmas::graph<std::uint64_t> Day23::trail_network(bool slopes) {
+  // Cache layout: number of nodes, edges with slopes, edges without them
+  if (auto cached = this->load_cached(cache_version); cached.has_value()) {
+    try {
+      const auto nnodes = cached->get<std::uint64_t>();
+      const auto with_slopes = cached->get_range<csr_graph::edge>();
+      const auto without_slopes = cached->get_range<csr_graph::edge>();
+      return csr_graph(nnodes, slopes ? with_slopes : without_slopes);
+    } catch (xmas::cache::format_error& err) {
+      // The edge changed without bumping cache_version: parse the input and overwrite the file
+      xlog::warning("ignoring the stale input cache of day 23: {}", err.what());
+    }
+  }
+
   xmas::views::text_matrix map(this->input);
   auto g = build_graph(map);
 
@@ -304,7 +348,29 @@ std::uint64_t Day23::part1() {
       std::format("This solution supports at most {} nodes", visit_record::size()));
   }
 
-  auto opt = longest_path(g, 0, 1);
+  // Without the cache, only the edges of this part are needed
+  if (!this->caching_input()) {
+    if (!slopes) {
+      make_bidirectional(g);
+    }
+    return csr_graph(g.nodes.size(), edge_list(g));
+  }
+
+  const auto with_slopes = edge_list(g);
+  make_bidirectional(g);
+  const auto without_slopes = edge_list(g);
+
+  xmas::cache::writer w;
+  w.put(std::uint64_t{g.nodes.size()});
+  w.put_range(with_slopes);
+  w.put_range(without_slopes);
+  this->store_cached(w, cache_version);
+
+  return csr_graph(g.nodes.size(), slopes ? with_slopes : without_slopes);
+}
+
+std::uint64_t Day23::part1() {
+  auto opt = longest_path(trail_network(true), 0, 1);
   if (!opt.has_value()) {
     throw std::runtime_error("Could not find a path to the exit");
   }
@@ -313,25 +379,10 @@ std::uint64_t Day23::part1() {
 }
 
 std::uint64_t Day23::part2() {
-  xmas::views::text_matrix map(this->input);
-  auto g = build_graph(map);
-
-  if (g.nodes.size() > visit_record::size()) {
-    throw std::runtime_error(
-      std::format("This solution supports at most {} nodes", visit_record::size()));
-  }
-
-  // Duplicate all edges in reverse
-  for (auto const& n : g.nodes) {
-    for (auto [dest, len] : n.neigbours) {
-      g.add_edge(dest, n.id, len, false);
-    }
-  }
-
-  auto opt = longest_path(g, 0, 1);
+  auto opt = longest_path(trail_network(false), 0, 1);
   if (!opt.has_value()) {
     throw std::runtime_error("Could not find a path to the exit");
   }
 
   return *opt;
-}
\ No newline at end of file
+}
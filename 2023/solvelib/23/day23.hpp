@@ -1,7 +1,10 @@
 #pragma once
 
+#include "xmaslib/graph/graph.hpp"
 #include "xmaslib/solution/solution.hpp"
 
+#include <cstdint>
+
 class Day23 : public xmas::solution {
 public:
   int day() override {
@@ -11,4 +14,9 @@ public:
 public:
   std::uint64_t part1() override;
   std::uint64_t part2() override;
+
+private:
+  // The trails between crossings, with the slopes or ignoring them. The edge lists of both
+  // are stored in the input cache.
+  xmas::graph<std::uint64_t> trail_network(bool slopes);
 };
@@ -1,6 +1,17 @@
 #include "day23.hpp"
 #include <doctest/doctest.h>
 
+#include "xmaslib/cache/cache.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
 TEST_CASE("Day 23") {
 
   SUBCASE("Part 1, example") {
@@ -38,4 +49,60 @@ TEST_CASE("Day 23") {
     REQUIRE_EQ(solution.part1(), 2178);
     REQUIRE_EQ(solution.part2(), 6486);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Day 23, stale input cache") {
+  namespace fs = std::filesystem;
+
+  const auto dir = fs::temp_directory_path() / std::format("xmas-day23-test-{}", ::getpid());
+  fs::create_directories(dir);
+  const std::string input = (dir / "input.txt").string();
+  const std::string cached = (dir / ".cache" / "input.txt").string();
+  fs::copy_file("./data/23/example.txt", input, fs::copy_options::overwrite_existing);
+
+  const auto read = [](std::string const& path) {
+    std::ifstream f(path, std::ios::binary);
+    std::stringstream buff;
+    buff << f.rdbuf();
+    return std::move(buff).str();
+  };
+
+  const auto solve = [&] {
+    Day23 solution{};
+    solution.set_input(input);
+    solution.load();
+    CHECK_EQ(solution.part1(), 94);
+    CHECK_EQ(solution.part2(), 154);
+  };
+
+  xmas::solution::enable_input_cache(true);
+
+  solve();
+  const auto valid = read(cached);
+  REQUIRE_FALSE(valid.empty());
+
+  // The edges with slopes, reinterpreted as twice as many values of half the size: as if the edge
+  // type had changed without a new cache version. They follow the number of nodes, which is
+  // padded to 16 bytes.
+  {
+    namespace cache = xmas::cache;
+    std::fstream f(cached, std::ios::binary | std::ios::in | std::ios::out);
+    const auto offset = std::streamoff(sizeof(cache::header) + sizeof(cache::section) + 16);
+    cache::section s;
+    f.seekg(offset);
+    f.read(reinterpret_cast<char*>(&s), sizeof(s));
+    REQUIRE_EQ(s.element_size, 16);
+    s.count *= 2;
+    s.element_size /= 2;
+    f.seekp(offset);
+    f.write(reinterpret_cast<const char*>(&s), sizeof(s));
+  }
+  REQUIRE_NE(read(cached), valid);
+
+  // The answers are computed from the input, and the file is replaced
+  solve();
+  CHECK_EQ(read(cached), valid);
+
+  xmas::solution::enable_input_cache(false);
+  fs::remove_all(dir);
+}
@@ -3,7 +3,7 @@
 #include "xmaslib/iota/iota.hpp"
 #include "xmaslib/log/log.hpp"
 #include "xmaslib/parsing/parsing.hpp"
-#include "xmaslib/line_iterator/line_iterator.hpp"
+#include "xmaslib/line_index/line_index.hpp"
 #include "xmaslib/matrix/dense_algebra.hpp"
 #include "xmaslib/matrix/dense_vector.hpp"
 
@@ -183,13 +183,14 @@ Line parse_line_2D(std::string_view text) {
 }
 
 std::uint64_t Day24::part1_generalized(std::int64_t min_xy, std::int64_t max_xy) {
-  xmas::views::linewise in(this->input);
+  const xmas::views::line_index in(this->input);
 
   auto min = Float(min_xy);
   auto max = Float(max_xy);
 
-  std::vector<Line> lines;
-  std::transform(in.cbegin(), in.cend(), std::back_inserter(lines), parse_line_2D);
+  // Not par_unseq: parse_ints allocates, which unsequenced element functions may not do
+  std::vector<Line> lines(in.size());
+  std::transform(std::execution::par, in.cbegin(), in.cend(), lines.begin(), parse_line_2D);
 
   xmas::views::iota<std::size_t> iota(lines.size());
 
@@ -333,10 +334,11 @@ std::optional<Line> solve_part_2(Line const& reference, Line L1, Line L2) {
 }
 
 std::uint64_t Day24::part2() {
-  xmas::views::linewise in(this->input);
+  const xmas::views::line_index in(this->input);
 
-  std::vector<Line> lines;
-  std::transform(in.begin(), in.end(), std::back_inserter(lines), parse_line_3D);
+  // Not par_unseq: parse_ints allocates, which unsequenced element functions may not do
+  std::vector<Line> lines(in.size());
+  std::transform(std::execution::par, in.begin(), in.end(), lines.begin(), parse_line_3D);
 
   // Solve
   std::optional<Line> solution;
@@ -26,6 +26,17 @@
 #include "solvelib/23/day23_test.hpp"
 #include "solvelib/24/day24_test.hpp"
 
+#include "xmaslib/arena/arena_test.hpp"
+#include "xmaslib/cache/cache_test.hpp"
+#include "xmaslib/cycle/cycle_test.hpp"
+#include "xmaslib/graph/graph_test.hpp"
+#include "xmaslib/integer_range/interval_set_test.hpp"
 #include "xmaslib/iota/iota_test.hpp"
+#include "xmaslib/line_index/line_index_test.hpp"
+#include "xmaslib/log/log_test.hpp"
 #include "xmaslib/lru/lru_test.hpp"
+#include "xmaslib/math/isqrt_test.hpp"
 #include "xmaslib/matrix/algebra_test.hpp"
+#include "xmaslib/matrix/csc_test.hpp"
+#include "xmaslib/matrix/padded_grid_test.hpp"
+#include "xmaslib/matrix/text_matrix_test.hpp"
@@ -0,0 +1,164 @@
+#include "arena.hpp"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace xmas {
+
+namespace {
+
+// counting_resource forwards to another resource and keeps track of how much it is used
+class counting_resource : public std::pmr::memory_resource {
+public:
+  explicit counting_resource(std::pmr::memory_resource* upstream) : upstream(upstream) {
+  }
+
+  std::uint64_t allocations = 0;
+  std::uint64_t bytes = 0;
+
+private:
+  std::pmr::memory_resource* upstream;
+
+  void* do_allocate(std::size_t size, std::size_t alignment) override {
+    ++allocations;
+    bytes += size;
+    return upstream->allocate(size, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t size, std::size_t alignment) override {
+    upstream->deallocate(p, size, alignment);
+  }
+
+  bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+// Identifies every arena ever created, so that a thread's cached shard is never
+// mistaken for one of a different arena created at the same address.
+std::atomic<std::uint64_t> next_id{1};
+
+} // namespace
+
+struct arena::state {
+  // shard is the memory of a single thread. Members are declared in the order
+  // they depend on each other.
+  class shard {
+  public:
+    explicit shard(std::size_t size) : size(size), buffer(new std::byte[size]) {
+      build();
+    }
+
+    std::pmr::memory_resource* resource() {
+      return &*served;
+    }
+
+    statistics stats() const {
+      return {
+        .allocations = served->allocations,
+        .bytes = served->bytes,
+        .heap_allocations = heap.allocations,
+      };
+    }
+
+    void reset() {
+      const auto overflow = heap.bytes;
+      teardown();
+      if (overflow != 0) {
+        size += overflow;
+        buffer.reset(new std::byte[size]);
+      }
+      heap.allocations = 0;
+      heap.bytes = 0;
+      build();
+    }
+
+  private:
+    std::size_t size;
+    std::unique_ptr<std::byte[]> buffer;
+    counting_resource heap{std::pmr::new_delete_resource()};
+    std::optional<std::pmr::monotonic_buffer_resource> monotonic;
+    std::optional<std::pmr::unsynchronized_pool_resource> pool;
+    std::optional<counting_resource> served;
+
+    void build() {
+      if (size == 0) {
+        monotonic.emplace(&heap);
+      } else {
+        monotonic.emplace(buffer.get(), size, &heap);
+      }
+      pool.emplace(&*monotonic);
+      served.emplace(&*pool);
+    }
+
+    void teardown() {
+      served.reset();
+      pool.reset();
+      monotonic.reset();
+    }
+  };
+
+  explicit state(std::size_t initial_size) : initial_size(initial_size) {
+  }
+
+  std::size_t initial_size;
+  std::uint64_t id = next_id++;
+
+  mutable std::mutex mutex;
+  std::map<std::thread::id, std::unique_ptr<shard>> shards;
+};
+
+arena::arena(std::size_t initial_size) : m_state(std::make_unique<state>(initial_size)) {
+}
+
+arena::arena(arena&&) noexcept = default;
+arena& arena::operator=(arena&&) noexcept = default;
+arena::~arena() = default;
+
+std::pmr::memory_resource* arena::resource() {
+  // Threads remember their shard of the last arena they used, so that the lock is
+  // only taken the first time.
+  thread_local struct {
+    std::uint64_t arena_id = 0;
+    state::shard* shard = nullptr;
+  } cache;
+
+  if (cache.arena_id == m_state->id) {
+    return cache.shard->resource();
+  }
+
+  std::scoped_lock lock(m_state->mutex);
+  auto& s = m_state->shards[std::this_thread::get_id()];
+  if (!s) {
+    s = std::make_unique<state::shard>(m_state->initial_size);
+  }
+
+  cache.arena_id = m_state->id;
+  cache.shard = s.get();
+  return s->resource();
+}
+
+void arena::reset() {
+  std::scoped_lock lock(m_state->mutex);
+  for (auto& [_, s] : m_state->shards) {
+    s->reset();
+  }
+}
+
+arena::statistics arena::stats() const {
+  std::scoped_lock lock(m_state->mutex);
+
+  statistics total;
+  for (auto const& [_, s] : m_state->shards) {
+    const auto st = s->stats();
+    total.allocations += st.allocations;
+    total.bytes += st.bytes;
+    total.heap_allocations += st.heap_allocations;
+  }
+  return total;
+}
+
+} // namespace xmas
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace xmas {
+
+/*
+arena hands out scratch memory that lives until the next call to reset.
+
+Every thread gets its own shard: a pool, so that containers that grow and
+shrink reuse their blocks, on top of a monotonic buffer. Shards need no
+locks, so the arena can be used from inside parallel algorithms as long as
+each task asks for the resource of its own thread.
+
+When a run outgrows a shard's buffer, the shard falls back to the heap. On
+reset, the buffer is enlarged to cover the whole run, so that repeated runs
+of the same workload eventually make no heap allocations at all.
+
+```c++
+auto* mem = scratch.resource();
+xmas::pmr::vector<beam> beams(mem);
+```
+*/
+class arena {
+public:
+  struct statistics {
+    std::uint64_t allocations = 0;      // Served by the arena
+    std::uint64_t bytes = 0;            // Served by the arena
+    std::uint64_t heap_allocations = 0; // Made by the arena when its buffers ran out
+  };
+
+  explicit arena(std::size_t initial_size = 0);
+  arena(arena&&) noexcept;
+  arena& operator=(arena&&) noexcept;
+  ~arena();
+
+  // Memory resource of the calling thread. Do not share it with other threads.
+  [[nodiscard]] std::pmr::memory_resource* resource();
+
+  // Releases all memory handed out since the last reset. No container allocated
+  // from the arena may be used afterwards.
+  void reset();
+
+  // Statistics since the last reset
+  [[nodiscard]] statistics stats() const;
+
+private:
+  struct state;
+  std::unique_ptr<state> m_state;
+};
+
+// Allocator-aware containers, to be constructed with an arena resource
+namespace pmr {
+
+template <typename T>
+using vector = std::pmr::vector<T>;
+
+template <typename T>
+using deque = std::pmr::deque<T>;
+
+template <typename K, typename Compare = std::less<K>>
+using set = std::pmr::set<K, Compare>;
+
+template <typename K, typename V, typename Compare = std::less<K>>
+using map = std::pmr::map<K, V, Compare>;
+
+template <typename K, typename Hash = std::hash<K>>
+using unordered_set = std::pmr::unordered_set<K, Hash>;
+
+template <typename K, typename V, typename Hash = std::hash<K>>
+using unordered_map = std::pmr::unordered_map<K, V, Hash>;
+
+using string = std::pmr::string;
+
+} // namespace pmr
+
+} // namespace xmas
@@ -0,0 +1,64 @@
+#include <doctest/doctest.h>
+
+#include "arena.hpp"
+
+#include <cstdint>
+#include <thread>
+
+TEST_CASE("Arena") {
+  xmas::arena arena;
+
+  const auto workload = [&arena] {
+    xmas::pmr::vector<std::uint64_t> v(arena.resource());
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+      v.push_back(i);
+    }
+    xmas::pmr::set<int> s({3, 1, 2}, arena.resource());
+    return v.back() + std::uint64_t(*s.begin());
+  };
+
+  SUBCASE("Counts allocations") {
+    REQUIRE_EQ(arena.stats().allocations, 0);
+
+    REQUIRE_EQ(workload(), 1000);
+    const auto stats = arena.stats();
+    REQUIRE_GT(stats.allocations, 3);
+    REQUIRE_GE(stats.bytes, 1000 * sizeof(std::uint64_t));
+    REQUIRE_GT(stats.heap_allocations, 0);
+
+    arena.reset();
+    REQUIRE_EQ(arena.stats().allocations, 0);
+    REQUIRE_EQ(arena.stats().heap_allocations, 0);
+  }
+
+  SUBCASE("Grows to fit the workload") {
+    REQUIRE_EQ(workload(), 1000);
+    arena.reset();
+
+    REQUIRE_EQ(workload(), 1000);
+    REQUIRE_GT(arena.stats().allocations, 0);
+    REQUIRE_EQ(arena.stats().heap_allocations, 0);
+  }
+
+  SUBCASE("One shard per thread") {
+    arena.reset();
+    auto* main_resource = arena.resource();
+    REQUIRE_EQ(arena.resource(), main_resource);
+
+    std::pmr::memory_resource* other_resource = nullptr;
+    std::thread t([&] {
+      other_resource = arena.resource();
+      xmas::pmr::vector<int> v(100, 0, other_resource);
+    });
+    t.join();
+
+    REQUIRE_NE(other_resource, main_resource);
+    REQUIRE_EQ(arena.stats().allocations, 1);
+  }
+
+  SUBCASE("Initial buffer") {
+    xmas::arena preallocated(1 << 16);
+    xmas::pmr::vector<std::uint64_t> v(1000, 0, preallocated.resource());
+    REQUIRE_EQ(preallocated.stats().heap_allocations, 0);
+  }
+}
@@ -0,0 +1,220 @@
+#include "cache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace xmas {
+namespace cache {
+
+namespace {
+
+constexpr std::array<char, 8> magic{'x', 'm', 'a', 's', 'b', 'i', 'n', '\0'};
+
+// Sections, and hence the values in them, start at multiples of this
+constexpr std::size_t alignment = 16;
+
+static_assert(sizeof(header) % alignment == 0);
+static_assert(sizeof(section) % alignment == 0);
+
+constexpr std::size_t padded(std::size_t n) noexcept {
+  return (n + alignment - 1) / alignment * alignment;
+}
+
+// Finalizer of splitmix64: every bit of the input affects every bit of the output
+constexpr std::uint64_t mix(std::uint64_t x) noexcept {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9u;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebu;
+  x ^= x >> 31;
+  return x;
+}
+
+} // namespace
+
+std::uint64_t hash(std::string_view data) noexcept {
+  constexpr std::uint64_t k = 0x9e3779b97f4a7c15u;
+
+  // Words are mixed independently of each other, so that the multiplications overlap, and
+  // only folded into the state in order
+  std::uint64_t h = data.size() * k;
+  std::size_t i = 0;
+  for (; i + sizeof(std::uint64_t) <= data.size(); i += sizeof(std::uint64_t)) {
+    std::uint64_t w;
+    std::memcpy(&w, data.data() + i, sizeof(w));
+    h = (h ^ mix(w)) * k;
+  }
+
+  if (i != data.size()) {
+    std::uint64_t w = 0;
+    std::memcpy(&w, data.data() + i, data.size() - i);
+    h = (h ^ mix(w)) * k;
+  }
+
+  return mix(h);
+}
+
+std::string temporary_path(std::string const& path) {
+  static std::atomic<std::uint64_t> count{0};
+  return std::format("{}.{}.{}.{}.tmp", path, ::getpid(),
+    std::hash<std::thread::id>{}(std::this_thread::get_id()), count.fetch_add(1));
+}
+
+std::optional<mapped_file> mapped_file::open(std::string const& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return {};
+  }
+
+  struct stat st{};
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return {};
+  }
+
+  const auto size = static_cast<std::size_t>(st.st_size);
+  void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // The map keeps the file alive
+  if (addr == MAP_FAILED) {
+    return {};
+  }
+
+  mapped_file f;
+  f.data = {static_cast<const std::byte*>(addr), size};
+  return {std::move(f)};
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept : data(std::exchange(other.data, {})) {
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+  mapped_file tmp(std::move(other));
+  std::swap(data, tmp.data);
+  return *this;
+}
+
+mapped_file::~mapped_file() {
+  if (!data.empty()) {
+    ::munmap(const_cast<std::byte*>(data.data()), data.size());
+  }
+}
+
+void writer::append(std::span<const std::byte> bytes) {
+  payload.insert(payload.end(), bytes.begin(), bytes.end());
+  payload.resize(padded(payload.size()));
+}
+
+void writer::save(std::string const& path, std::uint32_t version, std::uint64_t input_hash) const {
+  const header h{
+    .magic = magic,
+    .layout = layout_version,
+    .version = version,
+    .input_hash = input_hash,
+    .payload_size = payload.size(),
+  };
+
+  const std::filesystem::path target(path);
+  std::error_code ec;
+  if (target.has_parent_path()) {
+    std::filesystem::create_directories(target.parent_path(), ec);
+    if (ec) {
+      throw std::runtime_error(std::format("xmas::cache::writer::save: could not create {}: {}",
+        target.parent_path().string(), ec.message()));
+    }
+  }
+
+  const std::string tmp = temporary_path(path);
+  {
+    std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    f.write(reinterpret_cast<const char*>(payload.data()), std::streamsize(payload.size()));
+    if (!f.flush()) {
+      std::filesystem::remove(tmp, ec);
+      throw std::runtime_error(std::format("xmas::cache::writer::save: could not write {}", tmp));
+    }
+  }
+
+  std::filesystem::rename(tmp, target, ec);
+  if (ec) {
+    std::filesystem::remove(tmp, ec);
+    throw std::runtime_error(
+      std::format("xmas::cache::writer::save: could not write {}: {}", path, ec.message()));
+  }
+}
+
+std::optional<reader> reader::open(
+  std::string const& path, std::uint32_t version, std::uint64_t input_hash) {
+  auto f = mapped_file::open(path);
+  if (!f.has_value() || f->bytes().size() < sizeof(header)) {
+    return {};
+  }
+
+  header h;
+  std::memcpy(&h, f->bytes().data(), sizeof(h));
+  if (h.magic != magic || h.layout != layout_version || h.version != version
+      || h.input_hash != input_hash || h.payload_size != f->bytes().size() - sizeof(header)) {
+    return {};
+  }
+
+  // Every section must fit in the file, so that only reading them with the wrong types can fail
+  const auto size = f->bytes().size();
+  for (std::size_t offset = sizeof(header); offset != size;) {
+    section s;
+    if (size - offset < sizeof(s)) {
+      return {};
+    }
+    std::memcpy(&s, f->bytes().data() + offset, sizeof(s));
+    offset += sizeof(s);
+
+    if (s.element_size == 0 || s.count > (size - offset) / s.element_size
+        || padded(s.count * s.element_size) > size - offset) {
+      return {};
+    }
+    offset += padded(s.count * s.element_size);
+  }
+
+  return {reader(std::move(*f))};
+}
+
+std::span<const std::byte> reader::next_section(std::size_t element_size) {
+  const auto bytes = file.bytes();
+
+  section s;
+  if (bytes.size() - offset < sizeof(s)) {
+    throw format_error("xmas::cache::reader: read past the last section");
+  }
+  std::memcpy(&s, bytes.data() + offset, sizeof(s));
+  offset += sizeof(s);
+
+  if (s.element_size != element_size) {
+    throw format_error(std::format(
+      "xmas::cache::reader: section has elements of {} bytes (expected {})", s.element_size,
+      element_size));
+  }
+
+  // The sections were checked to fit in the file when it was opened
+  const auto data = bytes.subspan(offset, s.count * element_size);
+  offset += padded(data.size());
+  return data;
+}
+
+} // namespace cache
+} // namespace xmas
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xmas {
+namespace cache {
+
+// hash returns a 64 bit digest of the data. It is meant to notice that an input has changed,
+// not to resist collisions crafted on purpose.
+[[nodiscard]] std::uint64_t hash(std::string_view data) noexcept;
+
+// temporary_path returns a name next to path that no other writer, in any thread of any
+// process, uses at the same time. Files are written there and renamed to path, so that readers
+// never see them half written, and concurrent writers do not interleave: the last rename wins.
+[[nodiscard]] std::string temporary_path(std::string const& path);
+
+/*
+mapped_file is a read-only memory map of a whole file. It is unmapped on destruction.
+Moving it does not move the mapped bytes, so spans into them remain valid.
+*/
+class mapped_file {
+public:
+  mapped_file() = default;
+
+  // Maps the file at path, or returns nothing if it cannot be opened
+  [[nodiscard]] static std::optional<mapped_file> open(std::string const& path);
+
+  mapped_file(mapped_file&& other) noexcept;
+  mapped_file& operator=(mapped_file&& other) noexcept;
+  mapped_file(mapped_file const&) = delete;
+  mapped_file& operator=(mapped_file const&) = delete;
+  ~mapped_file();
+
+  [[nodiscard]] std::span<const std::byte> bytes() const noexcept {
+    return data;
+  }
+
+private:
+  std::span<const std::byte> data;
+};
+
+// format_error is thrown when a cache file does not hold the sections that are read from it,
+// which means that it was written by an older version of the solver. The file is stale.
+class format_error : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+// Values that can be stored in a cache file: they are copied byte by byte, and they must
+// contain no pointers (hence no containers) to make sense when they are read back.
+template <typename T>
+concept storable = std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> && alignof(T) <= 16;
+
+// Version of the layout of the files, as opposed to the version of their contents, which is
+// up to every solver. Bump it when changing the header or the sections.
+constexpr std::uint32_t layout_version = 1;
+
+// Every file starts with this header, followed by the sections
+struct header {
+  std::array<char, 8> magic;
+  std::uint32_t layout;
+  std::uint32_t version;
+  std::uint64_t input_hash;
+  std::uint64_t payload_size;
+};
+
+// Every section is a header and a list of values, padded to 16 bytes. The size of the
+// elements is stored to catch changes to their type that were not followed by a new version.
+struct section {
+  std::uint64_t count;
+  std::uint64_t element_size;
+};
+
+/*
+writer serializes a parsed input as a sequence of sections, each one a list of plain values.
+Files are written in one go, so that a reader never sees half a file.
+
+```c++
+xmas::cache::writer w;
+w.put(std::uint64_t{nnodes});
+w.put_range(edges);
+w.save("./data/23/.cache/input.txt", version, xmas::cache::hash(input));
+```
+*/
+class writer {
+public:
+  template <storable T>
+  void put(T const& value) {
+    put_range(std::span<const T>(&value, 1));
+  }
+
+  template <std::ranges::contiguous_range R>
+    requires storable<std::ranges::range_value_t<R>>
+  void put_range(R const& values) {
+    using T = std::ranges::range_value_t<R>;
+    const auto bytes = std::as_bytes(std::span<const T>(values));
+    const section s{.count = std::ranges::size(values), .element_size = sizeof(T)};
+    append(std::as_bytes(std::span(&s, 1)));
+    append(bytes);
+  }
+
+  // Writes the header and the sections into the file at path, creating its directory if needed.
+  // The file is written under a temporary name and renamed, so that readers never see it half
+  // written.
+  void save(std::string const& path, std::uint32_t version, std::uint64_t input_hash) const;
+
+private:
+  void append(std::span<const std::byte> bytes);
+
+  std::vector<std::byte> payload;
+};
+
+/*
+reader maps a file written by a writer and returns its sections in the same order. Ranges
+are returned as spans into the mapped file, without copying them: they are valid as long as
+the reader is alive.
+
+```c++
+auto r = xmas::cache::reader::open(path, version, xmas::cache::hash(input));
+if (r) {
+  auto nnodes = r->get<std::uint64_t>();
+  std::span<const edge> edges = r->get_range<edge>();
+}
+```
+*/
+class reader {
+public:
+  // Opens the file at path. It returns nothing if the file does not exist, if it is not a cache
+  // file, if its sections are corrupt, or if it was written with another layout, another version
+  // or for another input. Reading sections of another type throws a format_error.
+  [[nodiscard]] static std::optional<reader> open(
+    std::string const& path, std::uint32_t version, std::uint64_t input_hash);
+
+  template <storable T>
+  [[nodiscard]] T get() {
+    const auto values = get_range<T>();
+    if (values.size() != 1) {
+      throw format_error(std::format(
+        "xmas::cache::reader::get: expected a single value (found {})", values.size()));
+    }
+    return values.front();
+  }
+
+  template <storable T>
+  [[nodiscard]] std::span<const T> get_range() {
+    const auto bytes = next_section(sizeof(T));
+    // The map is page aligned and sections are padded to 16 bytes, so the values are aligned.
+    // They were written from objects of the same trivially copyable type.
+    return {reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T)};
+  }
+
+private:
+  explicit reader(mapped_file f) : file(std::move(f)), offset(sizeof(header)) {
+  }
+
+  std::span<const std::byte> next_section(std::size_t element_size);
+
+  mapped_file file;
+  std::size_t offset;
+};
+
+} // namespace cache
+} // namespace xmas
@@ -0,0 +1,95 @@
+#include <doctest/doctest.h>
+
+#include "cache.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+TEST_CASE("Input cache") {
+  namespace cache = xmas::cache;
+
+  const auto dir = std::filesystem::temp_directory_path()
+                   / std::format("xmas-cache-test-{}", ::getpid());
+  const std::string path = (dir / "input.txt").string();
+
+  struct record {
+    std::uint32_t id;
+    std::uint64_t value;
+  };
+
+  const std::vector<record> records{{1, 10}, {2, 20}, {3, 30}};
+  const std::string input = "some input\n";
+  const std::uint32_t version = 7;
+
+  cache::writer w;
+  w.put(std::uint64_t{42});
+  w.put_range(records);
+  w.put_range(std::string("abc"));
+  w.save(path, version, cache::hash(input));
+
+  SUBCASE("Hash") {
+    CHECK_EQ(cache::hash(input), cache::hash(std::string(input)));
+    CHECK_NE(cache::hash(input), cache::hash("some input!"));
+    CHECK_NE(cache::hash(""), cache::hash(std::string(1, '\0')));
+    CHECK_NE(cache::hash("12345678"), cache::hash("123456781"));
+  }
+
+  SUBCASE("Temporary paths") {
+    CHECK_NE(cache::temporary_path(path), cache::temporary_path(path));
+    CHECK(cache::temporary_path(path).starts_with(path));
+  }
+
+  SUBCASE("Round trip") {
+    auto r = cache::reader::open(path, version, cache::hash(input));
+    REQUIRE(r.has_value());
+    CHECK_EQ(r->get<std::uint64_t>(), 42);
+
+    const auto got = r->get_range<record>();
+    REQUIRE_EQ(got.size(), records.size());
+    for (std::size_t i = 0; i < got.size(); ++i) {
+      CHECK_EQ(got[i].id, records[i].id);
+      CHECK_EQ(got[i].value, records[i].value);
+    }
+
+    const auto text = r->get_range<char>();
+    CHECK_EQ(std::string(text.begin(), text.end()), "abc");
+
+    CHECK_THROWS(r->get_range<char>());
+  }
+
+  SUBCASE("Invalidation") {
+    CHECK_FALSE(cache::reader::open(path, version + 1, cache::hash(input)).has_value());
+    CHECK_FALSE(cache::reader::open(path, version, cache::hash("other input\n")).has_value());
+    CHECK_FALSE(cache::reader::open((dir / "missing").string(), version, 0).has_value());
+
+    // Truncated file
+    const std::string truncated = (dir / "truncated.txt").string();
+    std::filesystem::copy_file(path, truncated);
+    std::filesystem::resize_file(truncated, std::filesystem::file_size(path) - 16);
+    CHECK_FALSE(cache::reader::open(truncated, version, cache::hash(input)).has_value());
+
+    // Section longer than the file
+    const std::string corrupt = (dir / "corrupt.txt").string();
+    std::filesystem::copy_file(path, corrupt);
+    {
+      std::fstream f(corrupt, std::ios::binary | std::ios::in | std::ios::out);
+      const std::uint64_t count = 1000;
+      f.seekp(sizeof(cache::header));
+      f.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+    CHECK_FALSE(cache::reader::open(corrupt, version, cache::hash(input)).has_value());
+  }
+
+  SUBCASE("Type mismatch") {
+    auto r = cache::reader::open(path, version, cache::hash(input));
+    REQUIRE(r.has_value());
+    CHECK_THROWS_AS(r->get<std::uint32_t>(), cache::format_error);
+  }
+
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xmas {
+namespace cycle {
+
+/*
+Cycle detection for iterated functions and simulations.
+
+Every deterministic process with finitely many states eventually repeats itself: after
+`prefix` steps it enters a loop of `period` steps. Knowing both, the state and the
+accumulated metrics at any step N can be computed in O(prefix + period) steps, regardless of
+N, while storing only a few states.
+
+There are two flavours:
+- brent() and floyd() find the prefix and period of a pure function State -> State.
+- fast_forward(), accumulate() and steps_until() drive a simulation that is mutated in place
+  by a step function. A snapshot function extracts a compact, comparable state from it, so
+  the simulation itself is never copied.
+*/
+
+struct info {
+  std::size_t prefix; // Steps before entering the loop
+  std::size_t period; // Length of the loop
+
+  // The first step whose state is the same as at step n
+  [[nodiscard]] constexpr std::size_t equivalent(std::size_t n) const noexcept {
+    if (n < prefix + period) {
+      return n;
+    }
+    return prefix + (n - prefix) % period;
+  }
+};
+
+namespace detail {
+
+// Finds the length of the prefix, once the period is known, by walking two states that are
+// one period apart until they meet.
+template <typename State, typename Next, typename Equal>
+std::size_t find_prefix(State const& x0, std::size_t period, Next& next, Equal& eq) {
+  State tortoise = x0;
+  State hare = x0;
+  for (std::size_t i = 0; i < period; ++i) {
+    hare = next(hare);
+  }
+
+  std::size_t prefix = 0;
+  while (!eq(tortoise, hare)) {
+    tortoise = next(tortoise);
+    hare = next(hare);
+    ++prefix;
+  }
+  return prefix;
+}
+
+struct detection {
+  std::size_t steps;                 // Steps taken by the simulation
+  std::optional<std::size_t> period; // Set if the last state was seen before
+};
+
+// Advances the simulation until its state repeats, `limit` steps have been taken, or visit()
+// returns false. visit() is called after every step with what step() returned, if anything.
+//
+// This is the first phase of Brent's algorithm: the state is saved every power of two steps,
+// and every step is compared against the saved one. When they match, the saved state is
+// exactly one period behind and the simulation is at least `prefix` steps in.
+template <typename Sim, typename Step, typename Snapshot, typename Visit>
+detection detect(Sim& sim, std::size_t limit, Step& step, Snapshot& snapshot, Visit&& visit) {
+  using state = std::remove_cvref_t<std::invoke_result_t<Snapshot&, Sim const&>>;
+  using result = std::invoke_result_t<Step&, Sim&>;
+
+  state saved = snapshot(std::as_const(sim));
+  std::size_t power = 1;
+  std::size_t lambda = 0;
+
+  for (std::size_t steps = 1; steps <= limit; ++steps) {
+    if constexpr (std::is_void_v<result>) {
+      step(sim);
+      if (!visit()) {
+        return {steps, {}};
+      }
+    } else {
+      if (!visit(step(sim))) {
+        return {steps, {}};
+      }
+    }
+    ++lambda;
+
+    if (saved == snapshot(std::as_const(sim))) {
+      return {steps, lambda};
+    }
+
+    if (lambda == power) {
+      saved = snapshot(std::as_const(sim));
+      power *= 2;
+      lambda = 0;
+      visit.reset();
+    }
+  }
+
+  return {limit, {}};
+}
+
+// Combines `x` with itself n times (n > 0), with O(log n) operations
+template <typename T, typename Op>
+T repeat(T const& x, std::size_t n, Op& op) {
+  T result = x;
+  T power = x;
+  for (--n; n != 0; n /= 2) {
+    if (n % 2 == 1) {
+      result = op(result, power);
+    }
+    power = op(power, power);
+  }
+  return result;
+}
+
+struct no_visit {
+  bool operator()(auto&&...) const noexcept {
+    return true;
+  }
+  void reset() const noexcept {
+  }
+};
+
+// Stops the detection once done(sim) holds
+template <typename Sim, typename Done>
+struct until {
+  Sim const& sim;
+  Done& done;
+  bool reached = false;
+
+  bool operator()(auto&&...) {
+    reached = done(sim);
+    return !reached;
+  }
+  void reset() const noexcept {
+  }
+};
+
+} // namespace detail
+
+// Brent's algorithm: finds the prefix and period of the sequence x0, next(x0), next(next(x0)),
+// ... if the states repeat within max_steps steps. It takes fewer steps than Floyd's, and
+// stores at most three states.
+template <typename State, typename Next, typename Equal = std::equal_to<>>
+std::optional<info> brent(State const& x0, Next&& next, std::size_t max_steps, Equal eq = {}) {
+  State tortoise = x0;
+  State hare = next(x0);
+  std::size_t power = 1;
+  std::size_t period = 1;
+
+  for (std::size_t steps = 1; !eq(tortoise, hare); ++steps) {
+    if (steps >= max_steps) {
+      return {};
+    }
+    if (period == power) {
+      tortoise = hare;
+      power *= 2;
+      period = 0;
+    }
+    hare = next(hare);
+    ++period;
+  }
+
+  return info{.prefix = detail::find_prefix(x0, period, next, eq), .period = period};
+}
+
+// Floyd's algorithm: like brent(), with a tortoise that takes one step for every two of the
+// hare until they meet.
+template <typename State, typename Next, typename Equal = std::equal_to<>>
+std::optional<info> floyd(State const& x0, Next&& next, std::size_t max_steps, Equal eq = {}) {
+  State tortoise = next(x0);
+  State hare = next(tortoise);
+
+  for (std::size_t steps = 1; !eq(tortoise, hare); ++steps) {
+    if (steps >= max_steps) {
+      return {};
+    }
+    tortoise = next(tortoise);
+    hare = next(next(hare));
+  }
+
+  // The meeting point is a multiple of the period away from x0: find the period by
+  // walking around the loop once.
+  std::size_t period = 1;
+  for (hare = next(tortoise); !eq(tortoise, hare); hare = next(hare)) {
+    ++period;
+  }
+
+  return info{.prefix = detail::find_prefix(x0, period, next, eq), .period = period};
+}
+
+// Advances the simulation by n steps, skipping whole periods once its state repeats.
+template <typename Sim, typename Step, typename Snapshot>
+void fast_forward(Sim& sim, std::size_t n, Step&& step, Snapshot&& snapshot) {
+  const auto d = detail::detect(sim, n, step, snapshot, detail::no_visit{});
+  if (!d.period.has_value()) {
+    return;
+  }
+
+  for (std::size_t i = (n - d.steps) % *d.period; i != 0; --i) {
+    step(sim);
+  }
+}
+
+// Advances the simulation by n steps, and combines the metrics returned by every step with op,
+// starting from init. Once the state repeats, the metrics of whole periods are extrapolated.
+// The metrics must be a function of the state, and op must be associative.
+template <typename Sim, typename Step, typename Snapshot, typename Metric,
+  typename Op = std::plus<>>
+Metric accumulate(
+  Sim& sim, std::size_t n, Step&& step, Snapshot&& snapshot, Metric init, Op op = {}) {
+  // Only the metrics since the state was last saved are kept. When the state repeats, they
+  // are exactly one period.
+  struct recorder {
+    Op& op;
+    Metric total;
+    std::vector<Metric> window{};
+
+    bool operator()(Metric m) {
+      window.push_back(std::move(m));
+      return true;
+    }
+
+    void reset() {
+      for (auto& m : window) {
+        total = op(total, m);
+      }
+      window.clear();
+    }
+  } rec{.op = op, .total = std::move(init)};
+
+  const auto d = detail::detect(sim, n, step, snapshot, rec);
+  if (!d.period.has_value()) {
+    rec.reset();
+    return std::move(rec.total);
+  }
+
+  // The window holds the metrics of exactly one period, which repeats from now on
+  auto const& window = rec.window;
+  Metric one_period = window.front();
+  for (std::size_t i = 1; i < window.size(); ++i) {
+    one_period = op(one_period, window[i]);
+  }
+
+  Metric total = op(std::move(rec.total), one_period);
+
+  const std::size_t remaining = n - d.steps;
+  if (const std::size_t periods = remaining / *d.period; periods != 0) {
+    total = op(total, detail::repeat(one_period, periods, op));
+  }
+
+  // Step through the last partial period, so that the simulation ends at step n
+  for (std::size_t i = 0; i < remaining % *d.period; ++i) {
+    step(sim);
+    total = op(total, window[i]);
+  }
+
+  return total;
+}
+
+// Advances the simulation until done(sim) holds, and returns the number of steps taken. If
+// the state repeats first, done() never holds and an empty optional is returned.
+template <typename Sim, typename Step, typename Snapshot, typename Done>
+std::optional<std::size_t> steps_until(Sim& sim, Step&& step, Snapshot&& snapshot, Done&& done) {
+  if (done(std::as_const(sim))) {
+    return {0};
+  }
+
+  detail::until<Sim, Done> check{.sim = sim, .done = done};
+
+  constexpr auto unlimited = std::numeric_limits<std::size_t>::max();
+  const auto d = detail::detect(sim, unlimited, step, snapshot, check);
+  if (!check.reached) {
+    return {};
+  }
+  return {d.steps};
+}
+
+} // namespace cycle
+} // namespace xmas
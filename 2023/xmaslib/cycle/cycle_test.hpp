@@ -0,0 +1,152 @@
+#include "cycle.hpp"
+
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+TEST_CASE("Cycle detection") {
+  // x -> x² + 1 (mod m) eventually loops, with a prefix and period that depend on x0 and m
+  const auto square_plus_one = [](std::uint64_t m) {
+    return [m](std::uint64_t x) { return (x * x + 1) % m; };
+  };
+
+  // Finds the prefix and period by remembering every state
+  const auto brute_force = [](std::uint64_t x0, auto next) {
+    std::vector<std::uint64_t> seen{x0};
+    while (true) {
+      const auto x = next(seen.back());
+      for (std::size_t i = 0; i < seen.size(); ++i) {
+        if (seen[i] == x) {
+          return xmas::cycle::info{.prefix = i, .period = seen.size() - i};
+        }
+      }
+      seen.push_back(x);
+    }
+  };
+
+  SUBCASE("Brent and Floyd") {
+    for (std::uint64_t m : {1u, 2u, 7u, 100u, 1009u, 65536u}) {
+      for (std::uint64_t x0 : {0u, 3u, 17u}) {
+        const auto next = square_plus_one(m);
+        const auto want = brute_force(x0 % m, next);
+
+        const auto b = xmas::cycle::brent(x0 % m, next, 1'000'000);
+        REQUIRE(b.has_value());
+        CHECK_EQ(b->prefix, want.prefix);
+        CHECK_EQ(b->period, want.period);
+
+        const auto f = xmas::cycle::floyd(x0 % m, next, 1'000'000);
+        REQUIRE(f.has_value());
+        CHECK_EQ(f->prefix, want.prefix);
+        CHECK_EQ(f->period, want.period);
+      }
+    }
+
+    // Too few steps to find the loop
+    const auto next = [](std::uint64_t x) { return x + 1; };
+    CHECK_FALSE(xmas::cycle::brent(std::uint64_t{0}, next, 100).has_value());
+    CHECK_FALSE(xmas::cycle::floyd(std::uint64_t{0}, next, 100).has_value());
+  }
+
+  SUBCASE("Equivalent step") {
+    const xmas::cycle::info c{.prefix = 3, .period = 4};
+    CHECK_EQ(c.equivalent(0), 0);
+    CHECK_EQ(c.equivalent(6), 6);
+    CHECK_EQ(c.equivalent(7), 3);
+    CHECK_EQ(c.equivalent(1'000'000'000), 3 + (1'000'000'000 - 3) % 4);
+  }
+
+  // A simulation that is not a value: a counter that loops with a prefix, and whose
+  // snapshot ignores the number of steps taken
+  struct simulation {
+    std::uint64_t x;
+    std::size_t steps = 0;
+  };
+  const auto snapshot = [](simulation const& s) { return s.x; };
+  const auto next = square_plus_one(1009);
+
+  SUBCASE("Fast forward") {
+    for (std::size_t n : {0u, 1u, 5u, 30u, 31u, 1000u, 123'456'789u}) {
+      simulation sim{.x = 3};
+      xmas::cycle::fast_forward(sim, n, [&](simulation& s) { s.x = next(s.x); ++s.steps; },
+        snapshot);
+
+      std::uint64_t want = 3;
+      const auto c = brute_force(3, next);
+      for (std::size_t i = 0; i < c.equivalent(n); ++i) {
+        want = next(want);
+      }
+      CHECK_EQ(sim.x, want);
+      CHECK_LE(sim.steps, 4 * (c.prefix + c.period));
+    }
+  }
+
+  SUBCASE("Accumulate") {
+    const auto step = [&](simulation& s) {
+      s.x = next(s.x);
+      ++s.steps;
+      return std::pair<std::uint64_t, std::uint64_t>{s.x, 1};
+    };
+    const auto sum = [](auto l, auto r) {
+      return std::pair{l.first + r.first, l.second + r.second};
+    };
+
+    for (std::size_t n : {0u, 1u, 5u, 30u, 31u, 1000u, 123'456'789u}) {
+      simulation sim{.x = 3};
+      const auto got = xmas::cycle::accumulate(sim, n, step, snapshot,
+        std::pair<std::uint64_t, std::uint64_t>{0, 0}, sum);
+
+      // Reference: sum over the loop explicitly
+      const auto c = brute_force(3, next);
+      std::uint64_t want = 0;
+      std::uint64_t x = 3;
+      std::vector<std::uint64_t> loop;
+      for (std::size_t i = 0; i < c.prefix + c.period; ++i) {
+        x = next(x);
+        if (i < n && i < c.prefix) {
+          want += x;
+        } else if (i >= c.prefix) {
+          loop.push_back(x);
+        }
+      }
+      for (std::size_t i = c.prefix; i < n; ++i) {
+        want += loop[(i - c.prefix) % c.period];
+      }
+
+      CHECK_EQ(got.first, want);
+      CHECK_EQ(got.second, n);
+
+      std::uint64_t final_x = 3;
+      for (std::size_t i = 0; i < c.equivalent(n); ++i) {
+        final_x = next(final_x);
+      }
+      CHECK_EQ(sim.x, final_x);
+    }
+  }
+
+  SUBCASE("Steps until") {
+    const auto step = [&](simulation& s) { s.x = next(s.x); };
+    const auto c = brute_force(3, next);
+
+    // A state in the loop is reached, one that is not never is
+    std::uint64_t x = 3;
+    for (std::size_t i = 0; i < c.prefix + 2; ++i) {
+      x = next(x);
+    }
+
+    simulation sim{.x = 3};
+    auto got = xmas::cycle::steps_until(sim, step, snapshot,
+      [x](simulation const& s) { return s.x == x; });
+    REQUIRE(got.has_value());
+    CHECK_EQ(*got, c.prefix + 2);
+
+    sim = {.x = 3};
+    got = xmas::cycle::steps_until(sim, step, snapshot,
+      [](simulation const& s) { return s.x == 2000; });
+    CHECK_FALSE(got.has_value());
+  }
+}
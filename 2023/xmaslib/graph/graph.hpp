@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace xmas {
+
+/*
+graph is a directed graph with weighted edges, stored in compressed sparse row (CSR)
+format: the edges leaving every node are contiguous in memory, sorted by their origin.
+It is immutable once built.
+
+Nodes are numbered from 0 to size()-1. Undirected graphs are represented by adding every
+edge in both directions.
+
+```c++
+std::vector<xmas::graph<>::edge> edges{{0, 1, 5}, {1, 2, 3}, {0, 2, 9}};
+xmas::graph<> g(3, edges);
+for (auto [to, weight] : g.neighbours(0)) {
+  ...
+}
+```
+*/
+template <typename Weight = std::uint32_t>
+class graph {
+public:
+  // Node ids are 32 bits wide to keep the adjacency compact
+  using node_id = std::uint32_t;
+  using weight_type = Weight;
+
+  struct edge {
+    node_id from;
+    node_id to;
+    Weight weight;
+  };
+
+  struct arc {
+    node_id to;
+    Weight weight;
+  };
+
+  graph() : offsets{0} {
+  }
+
+  graph(std::size_t nnodes, std::span<const edge> edges) :
+      offsets(nnodes + 1, 0), arcs(edges.size()) {
+    if (nnodes > std::numeric_limits<node_id>::max()) {
+      throw std::runtime_error(
+        std::format("xmas::graph::graph: too many nodes (which is {})", nnodes));
+    }
+
+    // Counting sort of the edges by their origin, which keeps their relative order
+    for (auto const& e : edges) {
+      if (e.from >= nnodes || e.to >= nnodes) {
+        throw std::runtime_error(std::format(
+          "xmas::graph::graph: edge {}->{} out of range (nnodes is {})", e.from, e.to, nnodes));
+      }
+      ++offsets[e.from + 1];
+    }
+
+    for (std::size_t i = 0; i < nnodes; ++i) {
+      offsets[i + 1] += offsets[i];
+    }
+
+    std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (auto const& e : edges) {
+      arcs[cursor[e.from]++] = {e.to, e.weight};
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return offsets.size() - 1;
+  }
+
+  [[nodiscard]] std::size_t nedges() const noexcept {
+    return arcs.size();
+  }
+
+  [[nodiscard]] std::span<const arc> neighbours(node_id n) const noexcept {
+    return {arcs.data() + offsets[n], arcs.data() + offsets[n + 1]};
+  }
+
+  [[nodiscard]] std::size_t degree(node_id n) const noexcept {
+    return offsets[n + 1] - offsets[n];
+  }
+
+private:
+  std::vector<std::size_t> offsets; // Where the edges of every node begin, plus the end
+  std::vector<arc> arcs;
+};
+
+} // namespace xmas
@@ -0,0 +1,206 @@
+#include "graph.hpp"
+#include "priority_queue.hpp"
+#include "search.hpp"
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+TEST_CASE("Graph") {
+  using graph = xmas::graph<std::uint32_t>;
+  using node_id = graph::node_id;
+  constexpr auto unreachable = xmas::path_finder<std::uint32_t>::unreachable;
+
+  // Pseudo-random graph with n nodes and m edges of weight up to max_weight
+  const auto random_edges = [](std::size_t n, std::size_t m, std::uint32_t max_weight) {
+    std::vector<graph::edge> edges;
+    std::uint64_t state = 42;
+    const auto next = [&state] {
+      state = state * 6364136223846793005u + 1442695040888963407u;
+      return state >> 33;
+    };
+    for (std::size_t i = 0; i < m; ++i) {
+      edges.push_back({
+        .from = static_cast<node_id>(next() % n),
+        .to = static_cast<node_id>(next() % n),
+        .weight = static_cast<std::uint32_t>(next() % (max_weight + 1)),
+      });
+    }
+    return edges;
+  };
+
+  // Bellman-Ford, as a reference
+  const auto reference_distances = [unreachable](std::size_t n,
+                                     std::vector<graph::edge> const& edges, node_id source) {
+    std::vector<std::uint32_t> dist(n, unreachable);
+    dist[source] = 0;
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (auto e : edges) {
+        if (dist[e.from] != unreachable && dist[e.from] + e.weight < dist[e.to]) {
+          dist[e.to] = dist[e.from] + e.weight;
+          changed = true;
+        }
+      }
+    }
+    return dist;
+  };
+
+  SUBCASE("Adjacency") {
+    const std::vector<graph::edge> edges{{2, 0, 7}, {0, 1, 5}, {0, 2, 9}, {2, 1, 1}};
+    const graph g(4, edges);
+
+    REQUIRE_EQ(g.size(), 4);
+    REQUIRE_EQ(g.nedges(), 4);
+    CHECK_EQ(g.degree(0), 2);
+    CHECK_EQ(g.degree(1), 0);
+    CHECK_EQ(g.degree(3), 0);
+
+    // Edges keep their relative order
+    auto n2 = g.neighbours(2);
+    REQUIRE_EQ(n2.size(), 2);
+    CHECK_EQ(n2[0].to, 0);
+    CHECK_EQ(n2[0].weight, 7);
+    CHECK_EQ(n2[1].to, 1);
+    CHECK_EQ(n2[1].weight, 1);
+
+    REQUIRE_THROWS(graph(2, edges));
+  }
+
+  SUBCASE("Priority queues") {
+    xmas::binary_heap<std::uint32_t, int> binary;
+    xmas::dary_heap<std::uint32_t, int, 3> dary;
+    xmas::radix_heap<std::uint32_t, int> radix;
+    std::priority_queue<std::uint32_t, std::vector<std::uint32_t>, std::greater<>> reference;
+
+    // Monotone sequence of pushes and pops, so that the radix heap accepts it
+    std::uint64_t state = 7;
+    std::uint32_t last = 0;
+    for (int i = 0; i < 10'000; ++i) {
+      state = state * 6364136223846793005u + 1442695040888963407u;
+      if (reference.empty() || (state >> 60) < 9) {
+        const auto key = static_cast<std::uint32_t>(last + (state >> 33) % 1000);
+        binary.push(key, i);
+        dary.push(key, i);
+        radix.push(key, i);
+        reference.push(key);
+        continue;
+      }
+
+      last = reference.top();
+      reference.pop();
+      REQUIRE_EQ(binary.pop().first, last);
+      REQUIRE_EQ(dary.pop().first, last);
+      REQUIRE_EQ(radix.pop().first, last);
+    }
+
+    CHECK_EQ(binary.size(), reference.size());
+    CHECK_EQ(dary.size(), reference.size());
+    CHECK_EQ(radix.size(), reference.size());
+
+    radix.clear();
+    CHECK(radix.empty());
+    radix.push(3, 0); // Smaller than the last key before clearing
+    CHECK_EQ(radix.pop().first, 3);
+  }
+
+  SUBCASE("Breadth-first search") {
+    // 0 - 1 - 2 - 3    4
+    //      \     /
+    //       5 - 6
+    std::vector<graph::edge> edges;
+    for (auto [a, b] : std::array<std::pair<node_id, node_id>, 6>{
+           {{0, 1}, {1, 2}, {2, 3}, {1, 5}, {5, 6}, {6, 3}}}) {
+      edges.push_back({a, b, 100});
+      edges.push_back({b, a, 100});
+    }
+    const graph g(7, edges);
+
+    xmas::path_finder<std::uint32_t> finder;
+    std::vector<node_id> order;
+    const std::array<node_id, 1> sources{0};
+    finder.bfs(g, sources, [&](node_id n, std::uint32_t) { order.push_back(n); });
+
+    CHECK_EQ(order.size(), 6);
+    CHECK_EQ(order.front(), 0);
+    CHECK_EQ(finder.distance(order.back()), 3);
+    CHECK_EQ(finder.distance(3), 3);
+    CHECK_EQ(finder.distance(6), 3);
+    CHECK_EQ(finder.distance(4), unreachable);
+
+    // Pruning and stopping
+    finder.bfs(g, sources, [&](node_id n, std::uint32_t) {
+      return n == 5 ? xmas::search_action::prune : xmas::search_action::proceed;
+    });
+    CHECK_EQ(finder.distance(6), 4);
+
+    finder.bfs(g, sources, [&](node_id n, std::uint32_t) {
+      return n == 1 ? xmas::search_action::stop : xmas::search_action::proceed;
+    });
+    CHECK_EQ(finder.distance(2), unreachable);
+  }
+
+  SUBCASE("0-1 breadth-first search") {
+    const std::size_t n = 300;
+    auto edges = random_edges(n, 1200, 1);
+    const graph g(n, edges);
+    const auto want = reference_distances(n, edges, 0);
+
+    xmas::path_finder<std::uint32_t> finder;
+    const std::array<node_id, 1> sources{0};
+    std::uint32_t previous = 0;
+    finder.bfs01(g, sources, [&](node_id, std::uint32_t d) {
+      CHECK_LE(previous, d);
+      previous = d;
+    });
+
+    CHECK(std::ranges::equal(finder.distances(), want));
+  }
+
+  SUBCASE("Dijkstra and A*") {
+    const std::size_t n = 500;
+    auto edges = random_edges(n, 3000, 50);
+    const graph g(n, edges);
+    const auto want = reference_distances(n, edges, 0);
+    const std::array<node_id, 1> sources{0};
+
+    const auto check = [&](auto& finder) {
+      // Reused twice to check that the buffers are reset
+      for (int i = 0; i < 2; ++i) {
+        finder.dijkstra(g, sources, [](node_id, std::uint32_t) {});
+        CHECK(std::ranges::equal(finder.distances(), want));
+      }
+    };
+
+    xmas::path_finder<std::uint32_t> binary;
+    check(binary);
+    xmas::path_finder<std::uint32_t, xmas::dary_heap<std::uint32_t, node_id>> dary;
+    check(dary);
+    xmas::path_finder<std::uint32_t, xmas::radix_heap<std::uint32_t, node_id>> radix;
+    check(radix);
+
+    // A* towards a target. The heuristic d(0, target) - d(0, m) is consistent by the
+    // triangle inequality.
+    const node_id target = static_cast<node_id>(
+      std::ranges::find_if(want, [](auto d) { return d != 0 && d != unreachable; }) -
+      want.begin());
+    std::uint32_t found = unreachable;
+    radix.astar(
+      g, sources, [&](node_id m) { return want[target] - std::min(want[m], want[target]); },
+      [&](node_id m, std::uint32_t d) {
+        if (m != target) {
+          return xmas::search_action::proceed;
+        }
+        found = d;
+        return xmas::search_action::stop;
+      });
+    CHECK_EQ(found, want[target]);
+  }
+}
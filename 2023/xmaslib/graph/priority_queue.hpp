@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace xmas {
+
+/*
+Min-priority queues used by the shortest path algorithms. They all share the same
+interface, so they can be swapped for one another:
+
+```c++
+queue.push(key, value);
+auto [key, value] = queue.pop(); // Entry with the smallest key
+queue.empty();
+queue.clear(); // Keeps the allocated memory
+```
+
+Their memory is kept when they are cleared, so reusing a queue across searches does not
+allocate once it has grown large enough.
+*/
+
+// binary_heap is a binary min-heap on top of the standard heap algorithms
+template <typename Key, typename Value>
+class binary_heap {
+public:
+  using entry = std::pair<Key, Value>;
+
+  void push(Key key, Value value) {
+    data.emplace_back(key, value);
+    std::push_heap(data.begin(), data.end(), compare);
+  }
+
+  entry pop() {
+    assert(!empty());
+    std::pop_heap(data.begin(), data.end(), compare);
+    auto e = data.back();
+    data.pop_back();
+    return e;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return data.empty();
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return data.size();
+  }
+
+  void clear() noexcept {
+    data.clear();
+  }
+
+private:
+  static bool compare(entry const& l, entry const& r) noexcept {
+    return l.first > r.first;
+  }
+
+  std::vector<entry> data;
+};
+
+// dary_heap is a min-heap where every node has D children. It is shallower than a binary
+// heap, so pushes are cheaper, and the children of a node share cache lines.
+template <typename Key, typename Value, std::size_t D = 4>
+class dary_heap {
+  static_assert(D >= 2);
+
+public:
+  using entry = std::pair<Key, Value>;
+
+  void push(Key key, Value value) {
+    std::size_t i = data.size();
+    data.emplace_back(key, value);
+
+    // Sift up
+    const auto e = data[i];
+    while (i != 0) {
+      const std::size_t parent = (i - 1) / D;
+      if (!(e.first < data[parent].first)) {
+        break;
+      }
+      data[i] = data[parent];
+      i = parent;
+    }
+    data[i] = e;
+  }
+
+  entry pop() {
+    assert(!empty());
+    const auto top = data.front();
+    const auto e = data.back();
+    data.pop_back();
+
+    if (data.empty()) {
+      return top;
+    }
+
+    // Sift down
+    std::size_t i = 0;
+    while (true) {
+      const std::size_t first = i * D + 1;
+      if (first >= data.size()) {
+        break;
+      }
+
+      const std::size_t last = std::min(first + D, data.size());
+      std::size_t best = first;
+      for (std::size_t c = first + 1; c < last; ++c) {
+        if (data[c].first < data[best].first) {
+          best = c;
+        }
+      }
+
+      if (!(data[best].first < e.first)) {
+        break;
+      }
+      data[i] = data[best];
+      i = best;
+    }
+    data[i] = e;
+
+    return top;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return data.empty();
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return data.size();
+  }
+
+  void clear() noexcept {
+    data.clear();
+  }
+
+private:
+  std::vector<entry> data;
+};
+
+/*
+radix_heap is a monotone priority queue for unsigned integer keys: no key may be pushed
+that is smaller than the last one popped, which always holds in Dijkstra's algorithm with
+non-negative weights.
+
+Entries are kept in buckets according to the highest bit where their key differs from the
+last popped key. Every entry moves to a lower bucket at most once per bit, so operations
+take amortized O(log C) time, where C is the largest weight, regardless of the number of
+entries.
+*/
+template <std::unsigned_integral Key, typename Value>
+class radix_heap {
+public:
+  using entry = std::pair<Key, Value>;
+
+  void push(Key key, Value value) {
+    assert(key >= last);
+    buckets[bucket(key)].emplace_back(key, value);
+    ++count;
+  }
+
+  entry pop() {
+    assert(!empty());
+
+    if (buckets[0].empty()) {
+      // Redistribute the first non-empty bucket around its smallest key. Its entries all
+      // share their bits above the bucket index, so they all move to lower buckets.
+      std::size_t i = 1;
+      while (buckets[i].empty()) {
+        ++i;
+      }
+
+      auto& b = buckets[i];
+      last = std::ranges::min_element(b, {}, &entry::first)->first;
+      for (auto const& e : b) {
+        buckets[bucket(e.first)].push_back(e);
+      }
+      b.clear();
+    }
+
+    auto e = buckets[0].back();
+    buckets[0].pop_back();
+    --count;
+    return e;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return count == 0;
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return count;
+  }
+
+  void clear() noexcept {
+    for (auto& b : buckets) {
+      b.clear();
+    }
+    count = 0;
+    last = 0;
+  }
+
+private:
+  std::size_t bucket(Key key) const noexcept {
+    return static_cast<std::size_t>(std::bit_width(static_cast<Key>(key ^ last)));
+  }
+
+  std::array<std::vector<entry>, std::numeric_limits<Key>::digits + 1> buckets;
+  std::size_t count = 0;
+  Key last = 0;
+};
+
+} // namespace xmas
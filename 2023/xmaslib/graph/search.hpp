@@ -0,0 +1,209 @@
+#pragma once
+
+#include "graph.hpp"
+#include "priority_queue.hpp"
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xmas {
+
+// What a search should do after visiting a node
+enum class search_action {
+  proceed, // Explore the neighbours of the node
+  prune,   // Do not explore the neighbours of the node
+  stop,    // End the search
+};
+
+/*
+path_finder runs shortest path searches on an xmas::graph. It owns the buffers that the
+searches need, so running several searches with the same path_finder does not allocate
+once they have grown large enough.
+
+Every search starts from a set of sources at distance zero, and calls a visitor with
+every node it reaches, in order of increasing distance:
+
+```c++
+xmas::path_finder<std::uint32_t> finder;
+finder.dijkstra(g, sources, [&](auto node, auto distance) {
+  return node == target ? xmas::search_action::stop : xmas::search_action::proceed;
+});
+auto d = finder.distance(target);
+```
+
+The visitor may return nothing, which is the same as always proceeding. After a search,
+distance() holds the distances that it found. Nodes that were not reached are at distance
+unreachable.
+
+Queue is the priority queue used by Dijkstra and A*. See priority_queue.hpp.
+*/
+template <typename Weight, typename Queue = binary_heap<Weight, typename graph<Weight>::node_id>>
+class path_finder {
+public:
+  using graph_type = graph<Weight>;
+  using node_id = typename graph_type::node_id;
+
+  static constexpr Weight unreachable = std::numeric_limits<Weight>::max();
+
+  // Breadth-first search. The distance is the number of edges, so weights are ignored.
+  template <typename Visitor>
+  void bfs(graph_type const& g, std::span<const node_id> sources, Visitor&& visit) {
+    reset(g.size());
+
+    for (auto s : sources) {
+      if (dist[s] == unreachable) {
+        dist[s] = 0;
+        frontier.push_back(s);
+      }
+    }
+
+    for (std::size_t head = 0; head < frontier.size(); ++head) {
+      const auto n = frontier[head];
+      const auto action = invoke(visit, n, dist[n]);
+      if (action == search_action::stop) {
+        return;
+      }
+      if (action == search_action::prune) {
+        continue;
+      }
+
+      for (auto const& [to, _] : g.neighbours(n)) {
+        if (dist[to] == unreachable) {
+          dist[to] = static_cast<Weight>(dist[n] + 1);
+          frontier.push_back(to);
+        }
+      }
+    }
+  }
+
+  // Shortest paths in a graph where all weights are either zero or one. Nodes are
+  // explored one distance at a time, so no priority queue is needed.
+  template <typename Visitor>
+  void bfs01(graph_type const& g, std::span<const node_id> sources, Visitor&& visit) {
+    reset(g.size());
+
+    for (auto s : sources) {
+      dist[s] = 0;
+      frontier.push_back(s);
+    }
+
+    for (Weight d = 0; !frontier.empty(); ++d) {
+      // The frontier only holds nodes at distance d, so the order does not matter
+      while (!frontier.empty()) {
+        const auto n = frontier.back();
+        frontier.pop_back();
+        if (settled[n] != 0) {
+          continue;
+        }
+        settled[n] = 1;
+
+        const auto action = invoke(visit, n, d);
+        if (action == search_action::stop) {
+          return;
+        }
+        if (action == search_action::prune) {
+          continue;
+        }
+
+        for (auto const& [to, w] : g.neighbours(n)) {
+          assert(w == 0 || w == 1);
+          if (const auto dw = static_cast<Weight>(d + w); dw < dist[to]) {
+            dist[to] = dw;
+            (w == 0 ? frontier : next_frontier).push_back(to);
+          }
+        }
+      }
+
+      std::swap(frontier, next_frontier);
+    }
+  }
+
+  // Shortest paths in a graph with non-negative weights
+  template <typename Visitor>
+  void dijkstra(graph_type const& g, std::span<const node_id> sources, Visitor&& visit) {
+    astar(g, sources, [](node_id) { return Weight{0}; }, std::forward<Visitor>(visit));
+  }
+
+  // Shortest paths in a graph with non-negative weights, guided by a heuristic that
+  // estimates the distance from every node to the target. The heuristic must never
+  // overestimate, and must not decrease by more than the weight of any edge.
+  template <typename Heuristic, typename Visitor>
+    requires std::invocable<Heuristic, node_id>
+  void astar(
+    graph_type const& g, std::span<const node_id> sources, Heuristic&& h, Visitor&& visit) {
+    reset(g.size());
+
+    for (auto s : sources) {
+      if (dist[s] != 0) {
+        dist[s] = 0;
+        queue.push(h(s), s);
+      }
+    }
+
+    while (!queue.empty()) {
+      const auto n = queue.pop().second;
+      if (settled[n] != 0) {
+        continue; // Stale entry
+      }
+      settled[n] = 1;
+
+      const auto action = invoke(visit, n, dist[n]);
+      if (action == search_action::stop) {
+        return;
+      }
+      if (action == search_action::prune) {
+        continue;
+      }
+
+      for (auto const& [to, w] : g.neighbours(n)) {
+        if (const auto d = static_cast<Weight>(dist[n] + w); d < dist[to]) {
+          dist[to] = d;
+          queue.push(static_cast<Weight>(d + h(to)), to);
+        }
+      }
+    }
+  }
+
+  [[nodiscard]] Weight distance(node_id n) const noexcept {
+    return dist[n];
+  }
+
+  [[nodiscard]] std::span<const Weight> distances() const noexcept {
+    return dist;
+  }
+
+private:
+  void reset(std::size_t nnodes) {
+    dist.assign(nnodes, unreachable);
+    settled.assign(nnodes, 0);
+    frontier.clear();
+    next_frontier.clear();
+    queue.clear();
+  }
+
+  template <typename Visitor>
+  static search_action invoke(Visitor& visit, node_id n, Weight d) {
+    if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, node_id, Weight>>) {
+      visit(n, d);
+      return search_action::proceed;
+    } else {
+      return visit(n, d);
+    }
+  }
+
+  std::vector<Weight> dist;
+  std::vector<std::uint8_t> settled;
+  std::vector<node_id> frontier;
+  std::vector<node_id> next_frontier;
+  Queue queue;
+};
+
+} // namespace xmas
@@ -139,7 +139,7 @@ Iterator coalesce_ranges(Iterator begin, Iterator end) {
   auto ok_end = std::next(begin);
   for (auto it = ok_end; it != end; ++it) {
     integer_range<T>& curr = *it;
-    integer_range<T>& prev = *std::prev(it);
+    integer_range<T>& prev = *std::prev(ok_end);
     if (prev.end >= curr.begin) {
       // Overlap with previous range: extend the previous one to absorb this one
       prev.end = std::max(prev.end, curr.end);
@@ -155,8 +155,8 @@ Iterator coalesce_ranges(Iterator begin, Iterator end) {
 
 // coalesce_ranges takes a view of integer ranges and merges overlapping ones in-place.
 // This is a convenience implementation for vectors.
-template <typename T>
-void coalesce_ranges(std::vector<integer_range<T>>& v) {
+template <typename T, typename Allocator>
+void coalesce_ranges(std::vector<integer_range<T>, Allocator>& v) {
   auto end = xmas::coalesce_ranges(v.begin(), v.end());
   v.erase(end, v.end());
 }
@@ -0,0 +1,291 @@
+#pragma once
+
+#include "integer_range.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace xmas {
+
+/*
+interval_set is a set of integers stored as a sorted list of disjoint half-open ranges.
+Ranges that overlap or touch are merged, so there is a single way to represent every set.
+
+Ranges are stored in a flat vector: lookups are O(log n) binary searches, and inserting or
+erasing a range moves the ranges after it with a single memmove. Operations between two sets
+are linear merges.
+
+Buffers are kept between operations, so that solvers that propagate ranges through several
+stages can swap two sets back and forth instead of allocating new vectors at every stage.
+
+```c++
+xmas::interval_set<int> s{{0, 10}, {20, 30}};
+s.insert({10, 15});  // {[0, 15), [20, 30)}
+s.erase({5, 25});    // {[0, 5), [25, 30)}
+```
+*/
+template <std::integral T, typename Allocator = std::allocator<integer_range<T>>>
+class interval_set {
+public:
+  using range = integer_range<T>;
+  using container = std::vector<range, Allocator>;
+  using const_iterator = typename container::const_iterator;
+
+  // Part of a piecewise translation: the values in `from` are moved to start at `to`
+  struct piece {
+    range from;
+    T to;
+  };
+
+  interval_set() = default;
+
+  explicit interval_set(Allocator const& alloc) : ranges(alloc) {
+  }
+
+  interval_set(std::initializer_list<range> init, Allocator const& alloc = {}) : ranges(alloc) {
+    ranges.reserve(init.size());
+    for (range r : init) {
+      if (!r.empty()) {
+        ranges.push_back(r);
+      }
+    }
+    xmas::coalesce_ranges(ranges);
+  }
+
+  [[nodiscard]] const_iterator begin() const noexcept {
+    return ranges.begin();
+  }
+
+  [[nodiscard]] const_iterator end() const noexcept {
+    return ranges.end();
+  }
+
+  [[nodiscard]] range const& front() const noexcept {
+    return ranges.front();
+  }
+
+  [[nodiscard]] range const& back() const noexcept {
+    return ranges.back();
+  }
+
+  // Number of disjoint ranges
+  [[nodiscard]] std::size_t size() const noexcept {
+    return ranges.size();
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return ranges.empty();
+  }
+
+  // Number of integers in the set
+  [[nodiscard]] std::size_t count() const noexcept {
+    std::size_t n = 0;
+    for (range const& r : ranges) {
+      n += r.size();
+    }
+    return n;
+  }
+
+  void clear() noexcept {
+    ranges.clear();
+  }
+
+  void reserve(std::size_t n) {
+    ranges.reserve(n);
+  }
+
+  [[nodiscard]] bool contains(T x) const noexcept {
+    // First range that ends after x
+    auto it = std::ranges::upper_bound(ranges, x, {}, &range::end);
+    return it != ranges.end() && it->begin <= x;
+  }
+
+  void insert(range r) {
+    if (r.empty()) {
+      return;
+    }
+
+    // Every range from the first one that ends at r.begin or later, up to the last one that
+    // begins at r.end or earlier, is merged with r
+    auto first = std::ranges::lower_bound(ranges, r.begin, {}, &range::end);
+    auto last = std::ranges::upper_bound(ranges, r.end, {}, &range::begin);
+    if (first == last) {
+      ranges.insert(first, r);
+      return;
+    }
+
+    first->begin = std::min(first->begin, r.begin);
+    first->end = std::max(std::prev(last)->end, r.end);
+    ranges.erase(std::next(first), last);
+  }
+
+  void erase(range r) {
+    if (r.empty()) {
+      return;
+    }
+
+    // Ranges that overlap with r. Only the first and the last one may stick out of it.
+    auto first = std::ranges::upper_bound(ranges, r.begin, {}, &range::end);
+    auto last = std::ranges::lower_bound(ranges, r.end, {}, &range::begin);
+    if (first == last) {
+      return;
+    }
+
+    const T left = first->begin;
+    const T right = std::prev(last)->end;
+    auto it = ranges.erase(first, last);
+    if (r.end < right) {
+      it = ranges.insert(it, range{r.end, right});
+    }
+    if (left < r.begin) {
+      ranges.insert(it, range{left, r.begin});
+    }
+  }
+
+  // Union
+  interval_set& operator|=(interval_set const& other) {
+    container out(ranges.get_allocator());
+    out.reserve(ranges.size() + other.ranges.size());
+
+    auto a = ranges.cbegin();
+    auto b = other.ranges.cbegin();
+    while (a != ranges.cend() || b != other.ranges.cend()) {
+      const bool take_a =
+        b == other.ranges.cend() || (a != ranges.cend() && a->begin < b->begin);
+      append(out, take_a ? *a++ : *b++);
+    }
+
+    ranges.swap(out);
+    return *this;
+  }
+
+  // Intersection
+  interval_set& operator&=(interval_set const& other) {
+    container out(ranges.get_allocator());
+
+    auto a = ranges.cbegin();
+    auto b = other.ranges.cbegin();
+    while (a != ranges.cend() && b != other.ranges.cend()) {
+      const T begin = std::max(a->begin, b->begin);
+      const T end = std::min(a->end, b->end);
+      if (begin < end) {
+        out.emplace_back(begin, end);
+      }
+      // Whichever ends first cannot overlap with anything else
+      if (a->end < b->end) {
+        ++a;
+      } else {
+        ++b;
+      }
+    }
+
+    ranges.swap(out);
+    return *this;
+  }
+
+  // Difference
+  interval_set& operator-=(interval_set const& other) {
+    container out(ranges.get_allocator());
+    out.reserve(ranges.size());
+
+    auto b = other.ranges.cbegin();
+    for (range const& a : ranges) {
+      T cursor = a.begin;
+      while (b != other.ranges.cend() && b->end <= cursor) {
+        ++b;
+      }
+      while (b != other.ranges.cend() && b->begin < a.end) {
+        if (cursor < b->begin) {
+          out.emplace_back(cursor, b->begin);
+        }
+        cursor = std::max(cursor, b->end);
+        if (b->end > a.end) {
+          break; // It may overlap with the next range too
+        }
+        ++b;
+      }
+      if (cursor < a.end) {
+        out.emplace_back(cursor, a.end);
+      }
+    }
+
+    ranges.swap(out);
+    return *this;
+  }
+
+  // Translates every value by the piece that contains it, and leaves values outside of all
+  // pieces unchanged. The pieces must be sorted and disjoint. The result is written into out,
+  // whose buffer is reused.
+  void translate(std::span<const piece> pieces, interval_set& out) const {
+    assert(&out != this);
+    assert(std::ranges::is_sorted(pieces, {}, [](piece const& p) { return p.from.begin; }));
+
+    out.ranges.clear();
+    auto p = pieces.begin();
+    for (range r : ranges) {
+      while (p != pieces.end() && p->from.end <= r.begin) {
+        ++p;
+      }
+      for (auto q = p; q != pieces.end() && q->from.begin < r.end && !r.empty(); ++q) {
+        const range o = r.overlap(q->from);
+        if (r.begin < o.begin) {
+          out.ranges.emplace_back(r.begin, o.begin);
+        }
+        out.ranges.emplace_back(q->to + (o.begin - q->from.begin), q->to + (o.end - q->from.begin));
+        r.begin = o.end;
+      }
+      if (!r.empty()) {
+        out.ranges.push_back(r);
+      }
+    }
+
+    // Translated ranges may land anywhere
+    xmas::coalesce_ranges(out.ranges);
+  }
+
+  friend bool operator==(interval_set const& a, interval_set const& b) noexcept {
+    return std::ranges::equal(a.ranges, b.ranges,
+      [](range const& x, range const& y) { return x.begin == y.begin && x.end == y.end; });
+  }
+
+  friend interval_set operator|(interval_set a, interval_set const& b) {
+    return a |= b;
+  }
+
+  friend interval_set operator&(interval_set a, interval_set const& b) {
+    return a &= b;
+  }
+
+  friend interval_set operator-(interval_set a, interval_set const& b) {
+    return a -= b;
+  }
+
+private:
+  // Appends a range that begins no earlier than the last one, merging them if they touch
+  static void append(container& out, range r) {
+    if (!out.empty() && out.back().end >= r.begin) {
+      out.back().end = std::max(out.back().end, r.end);
+      return;
+    }
+    out.push_back(r);
+  }
+
+  container ranges;
+};
+
+namespace pmr {
+
+template <std::integral T>
+using interval_set = xmas::interval_set<T, std::pmr::polymorphic_allocator<integer_range<T>>>;
+
+} // namespace pmr
+
+} // namespace xmas
@@ -0,0 +1,113 @@
+#include "interval_set.hpp"
+
+#include <doctest/doctest.h>
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("Interval set") {
+  using set = xmas::interval_set<int>;
+
+  // Checks the set against a bitmap of the integers in [0, 64)
+  constexpr std::size_t universe = 64;
+  const auto check = [](set const& s, std::bitset<universe> const& want) {
+    std::bitset<universe> got;
+    for (auto r : s) {
+      REQUIRE_LT(r.begin, r.end);
+      for (int i = r.begin; i < r.end; ++i) {
+        got.set(static_cast<std::size_t>(i));
+      }
+    }
+    CHECK_EQ(got, want);
+    CHECK_EQ(s.count(), want.count());
+
+    // Ranges are sorted, and neither overlap nor touch
+    for (std::size_t i = 1; i < s.size(); ++i) {
+      CHECK_LT((s.begin() + static_cast<std::ptrdiff_t>(i) - 1)->end,
+        (s.begin() + static_cast<std::ptrdiff_t>(i))->begin);
+    }
+
+    for (std::size_t i = 0; i < universe; ++i) {
+      REQUIRE_EQ(s.contains(static_cast<int>(i)), want[i]);
+    }
+  };
+
+  const auto bits = [](int begin, int end) {
+    std::bitset<universe> b;
+    for (int i = begin; i < end; ++i) {
+      b.set(static_cast<std::size_t>(i));
+    }
+    return b;
+  };
+
+  SUBCASE("Construction") {
+    const set s{{20, 30}, {0, 10}, {5, 12}, {12, 14}, {40, 40}};
+    CHECK_EQ(s.size(), 2);
+    check(s, bits(0, 14) | bits(20, 30));
+  }
+
+  SUBCASE("Insert and erase") {
+    // Pseudo-random operations, checked against a bitmap
+    set s;
+    std::bitset<universe> want;
+    std::uint64_t state = 42;
+    const auto next = [&state](std::uint64_t mod) {
+      state = state * 6364136223846793005u + 1442695040888963407u;
+      return static_cast<int>((state >> 33) % mod);
+    };
+
+    for (int i = 0; i < 2000; ++i) {
+      const int begin = next(universe);
+      const int end = begin + next(universe - static_cast<std::size_t>(begin) + 1);
+      if (next(3) != 0) {
+        s.insert({begin, end});
+        want |= bits(begin, end);
+      } else {
+        s.erase({begin, end});
+        want &= ~bits(begin, end);
+      }
+      check(s, want);
+    }
+  }
+
+  SUBCASE("Set operations") {
+    const set a{{0, 10}, {20, 30}, {40, 50}};
+    const set b{{5, 25}, {30, 35}, {45, 46}, {60, 64}};
+    const auto wa = bits(0, 10) | bits(20, 30) | bits(40, 50);
+    const auto wb = bits(5, 25) | bits(30, 35) | bits(45, 46) | bits(60, 64);
+
+    check(a | b, wa | wb);
+    check(a & b, wa & wb);
+    check(a - b, wa & ~wb);
+    check(b - a, wb & ~wa);
+    check(a - a, {});
+    check(a & set{}, {});
+
+    CHECK_EQ(a | b, b | a);
+    CHECK_EQ(a & b, b & a);
+    CHECK_EQ((a | b) - b, a - b);
+  }
+
+  SUBCASE("Translate") {
+    using piece = set::piece;
+    const std::vector<piece> pieces{
+      {.from = {2, 6}, .to = 50},
+      {.from = {6, 8}, .to = 0},
+      {.from = {20, 30}, .to = 12},
+    };
+
+    const set s{{0, 10}, {18, 25}};
+    set out;
+    s.translate(pieces, out);
+
+    // [0, 2) and [8, 10) are unchanged, [6, 8) -> [0, 2), [2, 6) -> [50, 54), [18, 20) is
+    // unchanged and [20, 25) -> [12, 17)
+    check(out, bits(0, 2) | bits(8, 10) | bits(12, 17) | bits(18, 20) | bits(50, 54));
+
+    // The output buffer is reused
+    set{{60, 64}}.translate(pieces, out);
+    check(out, bits(60, 64));
+  }
+}
@@ -0,0 +1,88 @@
+#include "line_index.hpp"
+
+#include "../iota/iota.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <execution>
+#include <format>
+#include <numeric>
+#include <stdexcept>
+
+namespace xmas {
+namespace views {
+
+namespace {
+
+// Texts are split into chunks of this size, which are scanned independently
+constexpr std::size_t chunk_size = 1 << 18;
+
+// Texts shorter than this are scanned on a single thread
+constexpr std::size_t parallel_threshold = 1 << 20;
+
+// Writes the offset past every line break in the chunk to out, in order. The chunk
+// begins at the given offset of the text.
+void record_line_breaks(std::string_view chunk, std::size_t offset, std::size_t* out) {
+  const char* const begin = chunk.data();
+  const char* const end = begin + chunk.size();
+  for (const char* p = begin;
+       (p = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p))));) {
+    *out++ = offset + static_cast<std::size_t>(++p - begin);
+  }
+}
+
+}
+
+line_index::line_index(std::string_view text) : text(text) {
+  if (text.empty()) {
+    starts.push_back(0);
+    return;
+  }
+
+  const std::size_t nchunks = (text.size() + chunk_size - 1) / chunk_size;
+  const auto chunk = [&](std::size_t c) { return text.substr(c * chunk_size, chunk_size); };
+
+  const auto scan = [&](auto policy) {
+    const xmas::views::iota<std::size_t> chunks(nchunks);
+
+    // First pass: count the line breaks in every chunk to know where its lines go
+    std::vector<std::size_t> offsets(nchunks + 1, 0);
+    std::for_each(policy, chunks.begin(), chunks.end(), [&](std::size_t c) {
+      const auto ch = chunk(c);
+      offsets[c + 1] =
+        static_cast<std::size_t>(std::count(std::execution::unseq, ch.begin(), ch.end(), '\n'));
+    });
+    std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+
+    // An unterminated last line ends at an imaginary line break past the end
+    const std::size_t breaks = offsets.back();
+    const bool terminated = text.back() == '\n';
+    starts.resize(breaks + (terminated ? 1 : 2));
+    starts[0] = 0;
+    if (!terminated) {
+      starts.back() = text.size() + 1;
+    }
+
+    // Second pass: record the line breaks
+    std::for_each(policy, chunks.begin(), chunks.end(), [&](std::size_t c) {
+      record_line_breaks(chunk(c), c * chunk_size, starts.data() + offsets[c] + 1);
+    });
+  };
+
+  if (text.size() < parallel_threshold) {
+    scan(std::execution::seq);
+  } else {
+    scan(std::execution::par);
+  }
+}
+
+std::string_view line_index::at(size_type i) const {
+  if (i >= size()) {
+    throw std::runtime_error(std::format(
+      "xmas::views::line_index::at: index (which is {}) >= this->size() (which is {})", i, size()));
+  }
+  return (*this)[i];
+}
+
+} // namespace views
+} // namespace xmas
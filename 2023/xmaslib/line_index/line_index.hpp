@@ -0,0 +1,157 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+namespace xmas {
+namespace views {
+
+/*
+line_index is a view over the lines of a text, like linewise, but it finds all line
+breaks up front so that lines can be accessed by index. Its iterators are random access,
+so parallel algorithms can split the lines among threads.
+
+Lines are split the same way as in linewise: a trailing line break does not start an
+empty line. The text must outlive the index.
+*/
+class line_index {
+public:
+  class iterator;
+
+  using size_type = std::size_t;
+
+  explicit line_index(std::string_view text);
+
+  [[nodiscard]] iterator begin() const noexcept;
+  [[nodiscard]] iterator end() const noexcept;
+  [[nodiscard]] iterator cbegin() const noexcept;
+  [[nodiscard]] iterator cend() const noexcept;
+
+  [[nodiscard]] size_type size() const noexcept {
+    return starts.size() - 1;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  [[nodiscard]] std::string_view operator[](size_type i) const noexcept {
+    return text.substr(starts[i], starts[i + 1] - starts[i] - 1);
+  }
+
+  [[nodiscard]] std::string_view at(size_type i) const;
+
+private:
+  std::string_view text;
+
+  // Offset where every line begins, followed by one past the end of the last line break
+  // (real or not)
+  std::vector<std::size_t> starts;
+
+public:
+  class iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::string_view;
+    using pointer = void;
+    using reference = value_type;
+
+    iterator() noexcept = default;
+    iterator(line_index const* index, size_type pos) noexcept : index(index), pos(pos) {
+    }
+
+    iterator& operator++() noexcept {
+      ++pos;
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      auto it = *this;
+      ++pos;
+      return it;
+    }
+
+    iterator& operator--() noexcept {
+      --pos;
+      return *this;
+    }
+
+    iterator operator--(int) noexcept {
+      auto it = *this;
+      --pos;
+      return it;
+    }
+
+    iterator& operator+=(difference_type delta) noexcept {
+      pos = static_cast<size_type>(static_cast<difference_type>(pos) + delta);
+      return *this;
+    }
+
+    iterator& operator-=(difference_type delta) noexcept {
+      return *this += -delta;
+    }
+
+    [[nodiscard]] iterator operator+(difference_type delta) const noexcept {
+      auto it = *this;
+      return it += delta;
+    }
+
+    [[nodiscard]] friend iterator operator+(difference_type delta, iterator it) noexcept {
+      return it += delta;
+    }
+
+    [[nodiscard]] iterator operator-(difference_type delta) const noexcept {
+      auto it = *this;
+      return it -= delta;
+    }
+
+    [[nodiscard]] difference_type operator-(iterator other) const noexcept {
+      return static_cast<difference_type>(pos) - static_cast<difference_type>(other.pos);
+    }
+
+    [[nodiscard]] bool operator==(iterator other) const noexcept {
+      return pos == other.pos;
+    }
+
+    [[nodiscard]] std::strong_ordering operator<=>(iterator other) const noexcept {
+      return pos <=> other.pos;
+    }
+
+    [[nodiscard]] value_type operator*() const noexcept {
+      return (*index)[pos];
+    }
+
+    [[nodiscard]] value_type operator[](difference_type delta) const noexcept {
+      return *(*this + delta);
+    }
+
+  private:
+    line_index const* index = nullptr;
+    size_type pos = 0;
+  };
+};
+
+static_assert(std::random_access_iterator<line_index::iterator>);
+
+inline line_index::iterator line_index::begin() const noexcept {
+  return cbegin();
+}
+
+inline line_index::iterator line_index::end() const noexcept {
+  return cend();
+}
+
+inline line_index::iterator line_index::cbegin() const noexcept {
+  return {this, 0};
+}
+
+inline line_index::iterator line_index::cend() const noexcept {
+  return {this, size()};
+}
+
+} // namespace views
+} // namespace xmas
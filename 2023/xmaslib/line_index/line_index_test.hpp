@@ -0,0 +1,70 @@
+#include "line_index.hpp"
+
+#include "../line_iterator/line_iterator.hpp"
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <execution>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_CASE("Line index") {
+
+  // The index must split lines exactly like linewise does
+  const auto check_matches_linewise = [](std::string_view text) {
+    const xmas::views::linewise linewise(text);
+    const std::vector<std::string_view> want(linewise.begin(), linewise.end());
+
+    const xmas::views::line_index index(text);
+    REQUIRE_EQ(index.size(), want.size());
+    CHECK(std::equal(index.begin(), index.end(), want.begin(), want.end()));
+  };
+
+  SUBCASE("Splitting") {
+    check_matches_linewise("");
+    check_matches_linewise("\n");
+    check_matches_linewise("\n\n");
+    check_matches_linewise("abc");
+    check_matches_linewise("abc\n");
+    check_matches_linewise("abc\ndef");
+    check_matches_linewise("abc\n\ndef\n");
+    check_matches_linewise("\nabc\n");
+  }
+
+  SUBCASE("Random access") {
+    const xmas::views::line_index index("zero\none\ntwo\nthree\n");
+    REQUIRE_EQ(index.size(), 4);
+
+    CHECK_EQ(index[0], "zero");
+    CHECK_EQ(index[3], "three");
+    CHECK_EQ(index.at(2), "two");
+    REQUIRE_THROWS(index.at(4));
+
+    auto it = index.begin();
+    CHECK_EQ(it[1], "one");
+    CHECK_EQ(*(it + 2), "two");
+    CHECK_EQ(*(index.end() - 1), "three");
+    CHECK_EQ(index.end() - index.begin(), 4);
+    CHECK(index.begin() < index.end());
+  }
+
+  SUBCASE("Large input") {
+    // Long enough to be scanned in parallel, with lines straddling the chunks
+    std::string text;
+    for (std::size_t i = 0; text.size() < (std::size_t{3} << 20); ++i) {
+      text.append(i % 1000, 'x');
+      text.push_back('\n');
+    }
+    text.append("unterminated");
+
+    check_matches_linewise(text);
+
+    const xmas::views::line_index index(text);
+    const auto total = std::transform_reduce(std::execution::par_unseq, index.begin(), index.end(),
+      std::size_t{0}, std::plus<std::size_t>{}, [](std::string_view line) { return line.size(); });
+    CHECK_EQ(total + index.size() - 1, text.size());
+  }
+}
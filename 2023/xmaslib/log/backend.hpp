@@ -0,0 +1,196 @@
+#pragma once
+
+#include "log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace xlog {
+namespace internal {
+
+// A record holds a message, or a piece of it if it does not fit. Messages that span
+// several records are stored in consecutive slots.
+struct record {
+  static constexpr std::size_t payload = 244;
+
+  std::uint64_t seq;
+  std::uint16_t size;
+  std::uint8_t sever;
+  bool continued; // Whether the message continues in the next record
+  std::array<char, payload> text;
+};
+
+static_assert(sizeof(record) == 256);
+
+// ring is a single-producer single-consumer queue of records. The producer is the thread
+// that owns it, and the consumer is the writer thread.
+class ring {
+public:
+  static constexpr std::size_t capacity = 512;
+
+  static constexpr std::size_t records_for(std::size_t size) noexcept {
+    return std::max<std::size_t>(1, (size + record::payload - 1) / record::payload);
+  }
+
+  // Whether the message fits in an empty ring
+  static constexpr bool fits(std::string_view message) noexcept {
+    return records_for(message.size()) <= capacity;
+  }
+
+  // Tries to store the message, which must fit. Fails if there is not enough room for it.
+  // The sequence number is only taken once there is room, so that failed pushes leave no gaps.
+  template <typename NextSeq>
+  bool try_push(NextSeq&& next_seq, severity sever, std::string_view message) noexcept {
+    assert(fits(message));
+    const std::size_t needed = records_for(message.size());
+
+    const auto t = tail.load(std::memory_order_relaxed);
+    if (capacity - (t - head.load(std::memory_order_acquire)) < needed) {
+      return false;
+    }
+
+    const std::uint64_t seq = next_seq();
+    for (std::size_t i = 0; i < needed; ++i) {
+      auto& r = slots[(t + i) % capacity];
+      const auto chunk = message.substr(0, record::payload);
+      message.remove_prefix(chunk.size());
+
+      r.seq = seq;
+      r.sever = static_cast<std::uint8_t>(sever);
+      r.size = static_cast<std::uint16_t>(chunk.size());
+      r.continued = i + 1 < needed;
+      std::memcpy(r.text.data(), chunk.data(), chunk.size());
+    }
+
+    tail.store(t + needed, std::memory_order_release);
+    return true;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+  }
+
+  // Passes every complete message to f, and frees its slots
+  template <typename F>
+  std::size_t drain(F&& f) {
+    std::size_t h = head.load(std::memory_order_relaxed);
+    const std::size_t t = tail.load(std::memory_order_acquire);
+
+    std::size_t count = 0;
+    while (h != t) {
+      auto const& first = slots[h % capacity];
+      auto& text = f(first.seq, static_cast<severity>(first.sever));
+      for (;; ++h) {
+        auto const& r = slots[h % capacity];
+        text.append(r.text.data(), r.size);
+        if (!r.continued) {
+          ++h;
+          break;
+        }
+      }
+      ++count;
+    }
+
+    head.store(h, std::memory_order_release);
+    return count;
+  }
+
+  std::atomic<bool> orphaned = false; // Set when the owning thread exits
+
+private:
+  std::array<record, capacity> slots;
+  alignas(64) std::atomic<std::size_t> head = 0; // Written by the consumer only
+  alignas(64) std::atomic<std::size_t> tail = 0; // Written by the producer only
+};
+
+/*
+backend owns the rings of the threads that log through it, and the writer thread that drains
+them into an output stream. The global logger writes to stderr through one of them.
+
+Messages are numbered as they are pushed, and the writer holds back those that it drains ahead
+of a message that is still being pushed, so that they are written in the order they were logged
+even across threads.
+
+```c++
+std::stringstream out;
+xlog::internal::backend b(out);
+b.push(xlog::INFO, "Hello");
+b.flush(); // out holds the message
+```
+*/
+class backend {
+public:
+  explicit backend(std::ostream& out);
+
+  backend(backend const&) = delete;
+  backend& operator=(backend const&) = delete;
+
+  ~backend();
+
+  void push(severity sever, std::string_view message);
+
+  // Blocks until all messages pushed so far have been written
+  void flush();
+
+  // Writes the pending messages and stops the writer thread. Messages pushed while closing or
+  // afterwards are written synchronously, possibly ahead of messages still pending.
+  void close();
+
+  std::atomic<overflow_policy> policy = overflow_policy::block;
+
+private:
+  struct pending {
+    std::uint64_t seq;
+    severity sever;
+    std::string text;
+  };
+
+  std::ostream& out;
+  const std::uint64_t id; // Tells the rings of this backend apart in every thread
+
+  std::mutex rings_mutex;
+  std::vector<std::shared_ptr<ring>> rings;
+
+  std::mutex output_mutex; // Held while writing to out
+
+  std::atomic<std::uint64_t> next_seq = 0;
+  std::atomic<std::uint64_t> published = 0;
+  std::atomic<std::uint64_t> written = 0;
+  std::atomic<std::uint64_t> dropped = 0;
+
+  std::atomic<bool> closed = false;
+  std::atomic<std::size_t> inflight = 0; // Pushes that may still store into a ring
+
+  std::atomic<bool> stopping = false;
+  std::atomic<bool> sleeping = false;
+  std::atomic<std::uint64_t> wake_count = 0;
+
+  std::thread writer;
+
+  ring& this_thread_ring();
+  void push_to_ring(severity sever, std::string_view message);
+  void write_now(severity sever, std::string_view message);
+
+  void wake_writer();
+  void wake_writer_if_sleeping();
+
+  void write_loop();
+
+  // Whether any ring has messages, without consuming them
+  bool drain_pending();
+};
+
+} // namespace internal
+} // namespace xlog
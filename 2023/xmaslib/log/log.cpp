@@ -1,9 +1,59 @@
 #include "log.hpp"
+#include "backend.hpp"
+
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <format>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace xlog {
 
+namespace {
+
+std::string_view prefix(severity sever) {
+  switch (sever) {
+  case ERROR:
+    return "\x1b[31mERROR  \x1b[0m";
+  case WARNING:
+    return "\x1b[33mWARNING\x1b[0m";
+  case INFO:
+    return "INFO   ";
+  case DEBUG:
+    return "\x1b[34mDEBUG  \x1b[0m";
+  }
+  assert(false);
+  return "\x1b[31mUNKNOWN SEVERITY\x1b[0m";
+}
+
+// Set once the global backend is closed, after which messages are written synchronously.
+// It outlives the backend, so that messages logged during static destruction are not lost.
+std::atomic<bool> global_closed = false;
+
+struct global_holder {
+  internal::backend b{std::cerr};
+
+  ~global_holder() {
+    b.close();
+    global_closed.store(true);
+  }
+};
+
+internal::backend& global_backend() {
+  static global_holder g;
+  return g.b;
+}
+
+} // namespace
+
 logger& logger::global() {
   static logger global{};
   return global;
@@ -13,23 +63,256 @@ void logger::set_severity(severity s) {
   this->min_severity = s;
 }
 
+void logger::set_overflow_policy(overflow_policy p) {
+  global_backend().policy.store(p, std::memory_order_relaxed);
+}
+
+void logger::flush() {
+  if (!global_closed.load()) {
+    global_backend().flush();
+  }
+}
+
+std::string& logger::format_buffer() {
+  thread_local std::string buffer;
+  return buffer;
+}
+
 void logger::log_impl(severity sever, std::string_view message) {
-  const auto p = [sever]() -> std::string_view {
-    switch (sever) {
-    case ERROR:
-      return "\x1b[31mERROR  \x1b[0m";
-    case WARNING:
-      return "\x1b[33mWARNING\x1b[0m";
-    case INFO:
-      return "INFO   ";
-    case DEBUG:
-      return "\x1b[34mDEBUG  \x1b[0m";
-    }
-    assert(false);
-    return "\x1b[31mUNKNOWN SEVERITY\x1b[0m";
-  }();
-
-  std::cerr << std::format("{} {}\n", p, message) << std::flush;
+  if (global_closed.load(std::memory_order_relaxed)) {
+    std::cerr << std::format("{} {}\n", prefix(sever), message) << std::flush;
+    return;
+  }
+
+  auto& b = global_backend();
+  b.push(sever, message);
+
+  // Errors are written before returning, so that they are not lost if the process is about
+  // to abort or terminate
+  if (sever == ERROR) {
+    b.flush();
+  }
+}
+
+namespace internal {
+
+namespace {
+
+std::atomic<std::uint64_t> backend_count = 0;
+
+} // namespace
+
+backend::backend(std::ostream& out)
+    : out(out), id(backend_count.fetch_add(1)), writer([this] { write_loop(); }) {
+}
+
+backend::~backend() {
+  close();
+}
+
+void backend::close() {
+  if (closed.exchange(true)) {
+    return;
+  }
+
+  // Pairs with push: pushes that did not see the flag finish storing into the rings before
+  // the writer drains them for the last time
+  while (inflight.load() != 0) {
+    std::this_thread::yield();
+  }
+
+  stopping.store(true);
+  wake_writer();
+  writer.join();
+}
+
+void backend::push(severity sever, std::string_view message) {
+  inflight.fetch_add(1);
+  if (closed.load()) {
+    inflight.fetch_sub(1);
+    write_now(sever, message);
+    return;
+  }
+
+  push_to_ring(sever, message);
+  inflight.fetch_sub(1);
+}
+
+void backend::push_to_ring(severity sever, std::string_view message) {
+  if (!ring::fits(message)) {
+    // Too long for any ring: it is written right away, after everything logged before it
+    flush();
+    write_now(sever, message);
+    return;
+  }
+
+  auto& r = this_thread_ring();
+  const auto seq = [this] { return next_seq.fetch_add(1, std::memory_order_relaxed); };
+  while (!r.try_push(seq, sever, message)) {
+    if (policy.load(std::memory_order_relaxed) == overflow_policy::drop) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    wake_writer();
+    std::this_thread::yield();
+  }
+
+  published.fetch_add(1, std::memory_order_relaxed);
+  wake_writer_if_sleeping();
 }
 
+void backend::write_now(severity sever, std::string_view message) {
+  std::scoped_lock lock(output_mutex);
+  out << std::format("{} {}\n", prefix(sever), message) << std::flush;
+}
+
+void backend::flush() {
+  if (closed.load(std::memory_order_acquire)) {
+    return; // Everything was written when closing
+  }
+
+  const auto target = published.load(std::memory_order_acquire);
+  wake_writer();
+  for (auto w = written.load(std::memory_order_acquire); w < target;
+       w = written.load(std::memory_order_acquire)) {
+    written.wait(w, std::memory_order_acquire);
+  }
+}
+
+ring& backend::this_thread_ring() {
+  // The rings outlive their thread until the writer has drained them
+  struct owned {
+    std::uint64_t backend;
+    std::shared_ptr<ring> r;
+  };
+
+  struct owner {
+    std::vector<owned> rings;
+    ~owner() {
+      for (auto const& o : rings) {
+        o.r->orphaned.store(true, std::memory_order_release);
+      }
+    }
+  };
+  thread_local owner o;
+
+  for (auto const& [backend, r] : o.rings) {
+    if (backend == id) {
+      return *r;
+    }
+  }
+
+  auto r = std::make_shared<ring>();
+  {
+    std::scoped_lock lock(rings_mutex);
+    rings.push_back(r);
+  }
+  o.rings.push_back({id, r});
+  return *r;
+}
+
+void backend::wake_writer() {
+  wake_count.fetch_add(1, std::memory_order_release);
+  wake_count.notify_one();
+}
+
+void backend::wake_writer_if_sleeping() {
+  // Pairs with the fence in write_loop: either the writer sees the new message when
+  // it checks before sleeping, or this thread sees it asleep.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping.load(std::memory_order_relaxed)) {
+    wake_writer();
+  }
+}
+
+void backend::write_loop() {
+  // Messages drained but not written yet. They are held back while a message with a lower
+  // sequence number may still be in a ring.
+  std::vector<pending> batch;
+  std::size_t batch_size = 0;
+  std::uint64_t next_to_write = 0;
+  std::string text;
+
+  const auto next_entry = [&](std::uint64_t seq, severity sever) -> std::string& {
+    if (batch_size == batch.size()) {
+      batch.emplace_back();
+    }
+    auto& p = batch[batch_size++];
+    p.seq = seq;
+    p.sever = sever;
+    p.text.clear();
+    return p.text;
+  };
+
+  const auto drain_all = [&]() -> std::size_t {
+    std::size_t n = 0;
+    std::scoped_lock lock(rings_mutex);
+    for (auto const& r : rings) {
+      n += r->drain(next_entry);
+    }
+    std::erase_if(rings, [](auto const& r) {
+      return r->orphaned.load(std::memory_order_acquire) && r->empty();
+    });
+    return n;
+  };
+
+  // Writes the messages up to the first gap in the sequence, and keeps the rest for later
+  const auto write_ready = [&] {
+    const auto end = batch.begin() + std::ptrdiff_t(batch_size);
+    std::sort(batch.begin(), end, [](pending const& a, pending const& b) { return a.seq < b.seq; });
+
+    text.clear();
+    std::size_t n = 0;
+    for (; n < batch_size && batch[n].seq == next_to_write; ++n, ++next_to_write) {
+      std::format_to(std::back_inserter(text), "{} {}\n", prefix(batch[n].sever), batch[n].text);
+    }
+    if (const auto d = dropped.exchange(0, std::memory_order_relaxed); d != 0) {
+      std::format_to(
+        std::back_inserter(text), "{} {} log messages were dropped\n", prefix(WARNING), d);
+    }
+    if (!text.empty()) {
+      std::scoped_lock lock(output_mutex);
+      out << text << std::flush;
+    }
+
+    std::rotate(batch.begin(), batch.begin() + std::ptrdiff_t(n), end);
+    batch_size -= n;
+
+    written.fetch_add(n, std::memory_order_release);
+    written.notify_all();
+  };
+
+  while (true) {
+    const auto wake = wake_count.load(std::memory_order_acquire);
+
+    if (drain_all() != 0) {
+      write_ready();
+      continue;
+    }
+
+    if (stopping.load(std::memory_order_acquire)) {
+      // No push is in flight any more, so every message has been drained and written
+      assert(batch_size == 0);
+      return;
+    }
+
+    sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (drain_pending()) {
+      sleeping.store(false, std::memory_order_relaxed);
+      continue;
+    }
+    wake_count.wait(wake, std::memory_order_acquire);
+    sleeping.store(false, std::memory_order_relaxed);
+  }
+}
+
+bool backend::drain_pending() {
+  std::scoped_lock lock(rings_mutex);
+  return std::ranges::any_of(rings, [](auto const& r) { return !r->empty(); });
+}
+
+} // namespace internal
+
 } // namespace xlog
\ No newline at end of file
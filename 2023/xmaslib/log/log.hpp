@@ -1,6 +1,8 @@
 #pragma once
 
 #include <format>
+#include <iterator>
+#include <string>
 #include <string_view>
 #include <utility>
 
@@ -13,18 +15,45 @@ enum severity {
   ERROR,
 };
 
+// What to do when a thread logs faster than its messages can be written
+enum class overflow_policy {
+  block, // Wait until there is room for the message
+  drop,  // Discard the message (the number of discarded messages is reported later)
+};
+
+/*
+logger formats messages on the calling thread, and hands them over to a background
+thread that writes them to stderr.
+
+Every thread has its own lock-free ring buffer, so logging from inside parallel
+algorithms neither takes locks nor waits for I/O. Messages are written in the order
+they were logged, also across threads. Pending messages are flushed at exit, and later
+ones are written synchronously. See internal::backend in backend.hpp.
+
+Errors are the exception: they are flushed before log returns, so that they are written
+even if the process aborts right after. So are messages too long for the ring buffer.
+*/
 struct logger {
   severity min_severity = DEBUG;
 
   static logger& global();
   void set_severity(severity s);
+  void set_overflow_policy(overflow_policy p);
+
+  // Blocks until all messages logged so far have been written
+  void flush();
 
   template <typename... Args>
   void log(severity severity, std::format_string<Args...> msg, Args&&... args) {
     if (severity < min_severity) {
       return;
     }
-    return log_impl(severity, std::format(msg, std::forward<Args>(args)...));
+
+    // Reusing the buffer avoids allocating once it is large enough
+    auto& buffer = format_buffer();
+    buffer.clear();
+    std::format_to(std::back_inserter(buffer), msg, std::forward<Args>(args)...);
+    return log_impl(severity, buffer);
   }
 
   template <typename... Args>
@@ -51,6 +80,7 @@ struct logger {
   }
 
 private:
+  static std::string& format_buffer();
   void log_impl(severity prefix, std::string_view message);
 };
 
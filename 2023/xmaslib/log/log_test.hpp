@@ -0,0 +1,275 @@
+#include <doctest/doctest.h>
+
+#include "backend.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace log_test {
+
+// The lines written by a backend, without their severity prefix. Only INFO messages, and the
+// warnings of the backend itself, are expected.
+inline std::vector<std::string> messages(std::stringstream const& out) {
+  constexpr std::string_view info = "INFO    ";
+  constexpr std::string_view colour_end = "\x1b[0m ";
+
+  std::vector<std::string> lines;
+  std::istringstream in(out.str());
+  for (std::string line; std::getline(in, line);) {
+    if (line.starts_with(info)) {
+      lines.push_back(line.substr(info.size()));
+    } else if (auto end = line.find(colour_end); end != std::string::npos) {
+      lines.push_back(line.substr(end + colour_end.size()));
+    } else {
+      lines.push_back(line);
+    }
+  }
+  return lines;
+}
+
+// A stream buffer that blocks the first write until it is opened, to stall the writer thread
+class gated_buffer : public std::stringbuf {
+public:
+  std::atomic<bool> entered = false;
+  std::atomic<bool> opened = false;
+
+  void open() {
+    opened.store(true);
+    opened.notify_all();
+  }
+
+  void wait_until_entered() {
+    entered.wait(false);
+  }
+
+protected:
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    wait();
+    return std::stringbuf::xsputn(s, n);
+  }
+
+  int_type overflow(int_type c) override {
+    wait();
+    return std::stringbuf::overflow(c);
+  }
+
+private:
+  void wait() {
+    entered.store(true);
+    entered.notify_all();
+    opened.wait(false);
+  }
+};
+
+} // namespace log_test
+
+TEST_CASE("Log") {
+  using xlog::internal::backend;
+  using xlog::internal::ring;
+  using namespace log_test;
+
+  SUBCASE("Order within a thread") {
+    std::stringstream out;
+    backend b(out);
+    for (int i = 0; i < 3000; ++i) {
+      b.push(xlog::INFO, std::format("{}", i));
+    }
+    b.flush();
+
+    const auto lines = messages(out);
+    REQUIRE_EQ(lines.size(), 3000);
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+      CHECK_EQ(lines[i], std::format("{}", i));
+    }
+  }
+
+  SUBCASE("Order across threads") {
+    // Two threads take turns, so every message is logged after the previous one returned
+    constexpr int n = 2000;
+    std::stringstream out;
+    backend b(out);
+    std::atomic<int> turn = 0;
+
+    const auto player = [&](int parity) {
+      for (int i = parity; i < n; i += 2) {
+        for (int t = turn.load(); t != i; t = turn.load()) {
+          turn.wait(t);
+        }
+        b.push(xlog::INFO, std::format("{}", i));
+        turn.store(i + 1);
+        turn.notify_all();
+      }
+    };
+
+    std::thread even(player, 0);
+    std::thread odd(player, 1);
+    even.join();
+    odd.join();
+    b.flush();
+
+    const auto lines = messages(out);
+    REQUIRE_EQ(lines.size(), n);
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+      CHECK_EQ(lines[i], std::format("{}", i));
+    }
+  }
+
+  SUBCASE("Concurrent threads") {
+    constexpr int nthreads = 4;
+    constexpr int n = 2000;
+    std::stringstream out;
+    backend b(out);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; ++t) {
+      threads.emplace_back([&b, t] {
+        for (int i = 0; i < n; ++i) {
+          b.push(xlog::INFO, std::format("{} {}", t, i));
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    b.flush();
+
+    // Every message is written once, and the messages of each thread in order
+    std::vector<int> next(nthreads, 0);
+    const auto lines = messages(out);
+    CHECK_EQ(lines.size(), nthreads * n);
+    for (auto const& line : lines) {
+      std::istringstream in(line);
+      int t, i;
+      in >> t >> i;
+      REQUIRE_EQ(i, next[std::size_t(t)]);
+      ++next[std::size_t(t)];
+    }
+  }
+
+  SUBCASE("Long messages") {
+    const std::string multi_record(1000, 'a');                           // Spans a few records
+    const std::string oversized(ring::capacity * xlog::internal::record::payload + 1, 'b');
+
+    std::stringstream out;
+    backend b(out);
+    b.push(xlog::INFO, "before");
+    b.push(xlog::INFO, multi_record);
+    b.push(xlog::INFO, oversized);
+    b.push(xlog::INFO, "after");
+    b.flush();
+
+    const auto lines = messages(out);
+    REQUIRE_EQ(lines.size(), 4);
+    CHECK_EQ(lines[0], "before");
+    CHECK_EQ(lines[1], multi_record);
+    CHECK_EQ(lines[2], oversized);
+    CHECK_EQ(lines[3], "after");
+  }
+
+  SUBCASE("Overflow policy: drop") {
+    constexpr std::size_t extra = 10;
+    gated_buffer buffer;
+    std::ostream out(&buffer);
+    backend b(out);
+    b.policy = xlog::overflow_policy::drop;
+
+    // The writer takes the first message, and stalls writing it
+    b.push(xlog::INFO, "first");
+    buffer.wait_until_entered();
+
+    for (std::size_t i = 0; i < ring::capacity + extra; ++i) {
+      b.push(xlog::INFO, std::format("{}", i));
+    }
+
+    buffer.open();
+    b.flush();
+
+    std::stringstream text(buffer.str());
+    const auto lines = messages(text);
+    REQUIRE_EQ(lines.size(), ring::capacity + 2);
+    CHECK_EQ(lines.front(), "first");
+    CHECK_EQ(lines[ring::capacity], std::format("{}", ring::capacity - 1));
+    CHECK_EQ(lines.back(), std::format("{} log messages were dropped", extra));
+  }
+
+  SUBCASE("Overflow policy: block") {
+    constexpr std::size_t total = ring::capacity + 10;
+    gated_buffer buffer;
+    std::ostream out(&buffer);
+    backend b(out);
+
+    b.push(xlog::INFO, "first");
+    buffer.wait_until_entered();
+
+    // The ring fills up, so the thread cannot finish until the writer resumes
+    std::atomic<bool> done = false;
+    std::thread producer([&] {
+      for (std::size_t i = 0; i < total; ++i) {
+        b.push(xlog::INFO, std::format("{}", i));
+      }
+      done = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_FALSE(done.load());
+
+    buffer.open();
+    producer.join();
+    b.flush();
+
+    std::stringstream text(buffer.str());
+    const auto lines = messages(text);
+    REQUIRE_EQ(lines.size(), total + 1);
+    CHECK_EQ(lines.back(), std::format("{}", total - 1));
+  }
+
+  SUBCASE("Flush") {
+    std::stringstream out;
+    backend b(out);
+    for (int i = 0; i < 10; ++i) {
+      b.push(xlog::INFO, std::format("{}", i));
+      b.flush();
+      CHECK_EQ(messages(out).size(), std::size_t(i + 1));
+    }
+  }
+
+  SUBCASE("Shutdown") {
+    // Messages pushed while closing are not lost, and later ones are written synchronously
+    constexpr int nthreads = 4;
+    constexpr int n = 5000;
+    std::stringstream out;
+    backend b(out);
+
+    std::atomic<int> pushed = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; ++t) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < n; ++i) {
+          b.push(xlog::INFO, "message");
+          pushed.fetch_add(1);
+        }
+      });
+    }
+
+    while (pushed.load() < n) {
+      std::this_thread::yield();
+    }
+    b.close();
+
+    for (auto& t : threads) {
+      t.join();
+    }
+    b.push(xlog::INFO, "closed");
+
+    const auto lines = messages(out);
+    CHECK_EQ(lines.size(), nthreads * n + 1);
+    CHECK_EQ(lines.back(), "closed");
+  }
+}
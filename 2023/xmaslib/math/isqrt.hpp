@@ -0,0 +1,89 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+namespace xmas {
+
+__extension__ using uint128_t = unsigned __int128;
+
+// wider_t is the unsigned type with twice as many bits as T
+template <typename T>
+struct wider;
+
+template <>
+struct wider<std::uint8_t> {
+  using type = std::uint16_t;
+};
+
+template <>
+struct wider<std::uint16_t> {
+  using type = std::uint32_t;
+};
+
+template <>
+struct wider<std::uint32_t> {
+  using type = std::uint64_t;
+};
+
+template <>
+struct wider<std::uint64_t> {
+  using type = uint128_t;
+};
+
+template <typename T>
+using wider_t = typename wider<T>::type;
+
+// Number of bits needed to represent n. Unlike std::bit_width, it accepts uint128_t.
+template <typename T>
+[[nodiscard]] constexpr int bit_width(T n) noexcept {
+  if constexpr (sizeof(T) > sizeof(std::uint64_t)) {
+    if (const auto high = static_cast<std::uint64_t>(n >> 64); high != 0) {
+      return 64 + static_cast<int>(std::bit_width(high));
+    }
+  }
+  return static_cast<int>(std::bit_width(static_cast<std::uint64_t>(n)));
+}
+
+/*
+isqrt computes the floor of the square root of n exactly, using Newton's method.
+
+The floating point root is used as a first guess. One Newton step takes any
+positive guess to a value no smaller than the root, after which the iterates
+decrease monotonically and the loop stops as soon as they no longer do. The
+guess is accurate, so this usually takes two or three divisions. All iterates
+are close to the root, so they cannot overflow.
+*/
+template <typename T>
+[[nodiscard]] constexpr T isqrt(T n) noexcept {
+  if (n < 2) {
+    return n;
+  }
+
+  // Narrow divisions are much cheaper than 128-bit ones
+  if constexpr (sizeof(T) > sizeof(std::uint64_t)) {
+    if ((n >> 64) == 0) {
+      return isqrt(static_cast<std::uint64_t>(n));
+    }
+  }
+
+  T x;
+  if (std::is_constant_evaluated()) {
+    x = static_cast<T>(T{1} << ((bit_width(n) + 1) / 2));
+  } else {
+    x = static_cast<T>(std::sqrt(static_cast<double>(n)));
+    x = x == 0 ? T{1} : x;
+  }
+
+  x = static_cast<T>((x + n / x) / 2);
+  T y = static_cast<T>((x + n / x) / 2);
+  while (y < x) {
+    x = y;
+    y = static_cast<T>((x + n / x) / 2);
+  }
+  return x;
+}
+
+} // namespace xmas
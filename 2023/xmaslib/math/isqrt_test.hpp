@@ -0,0 +1,40 @@
+#include <doctest/doctest.h>
+
+#include "isqrt.hpp"
+
+#include <cstdint>
+#include <limits>
+
+TEST_CASE("isqrt") {
+  SUBCASE("Small values") {
+    for (std::uint32_t r = 0; r < 1000; ++r) {
+      REQUIRE_EQ(xmas::isqrt(r * r), r);
+      REQUIRE_EQ(xmas::isqrt(r * r + 2 * r), r);
+      REQUIRE_EQ(xmas::isqrt(r * r + 2 * r + 1), r + 1);
+    }
+  }
+
+  SUBCASE("8 bits") {
+    for (unsigned n = 0; n < 256; ++n) {
+      const auto r = xmas::isqrt(static_cast<std::uint8_t>(n));
+      REQUIRE_LE(unsigned{r} * r, n);
+      REQUIRE_GT((unsigned{r} + 1) * (r + 1), n);
+    }
+  }
+
+  SUBCASE("64 bits") {
+    constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+    REQUIRE_EQ(xmas::isqrt(max), 0xFFFFFFFF);
+    REQUIRE_EQ(xmas::isqrt(std::uint64_t{0xFFFFFFFE00000001}), 0xFFFFFFFF);
+    REQUIRE_EQ(xmas::isqrt(std::uint64_t{0xFFFFFFFE00000000}), 0xFFFFFFFE);
+  }
+
+  SUBCASE("128 bits") {
+    constexpr auto max64 = std::numeric_limits<std::uint64_t>::max();
+    const auto square = xmas::uint128_t{max64} * max64;
+
+    REQUIRE_EQ(static_cast<std::uint64_t>(xmas::isqrt(square)), max64);
+    REQUIRE_EQ(static_cast<std::uint64_t>(xmas::isqrt(square - 1)), max64 - 1);
+    REQUIRE_EQ(static_cast<std::uint64_t>(xmas::isqrt(~xmas::uint128_t{0})), max64);
+  }
+}
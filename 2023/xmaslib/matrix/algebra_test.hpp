@@ -6,6 +6,12 @@
 #include "dense_matrix.hpp"
 #include "../log/log.hpp"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+
 TEST_CASE("QR decomoposion") {
 
   SUBCASE("Wikipedia example") {
@@ -103,3 +109,156 @@ TEST_CASE("QR decomoposion") {
     CHECK_EQ(R[2][2], doctest::Approx(1.0));
   }
 }
+
+TEST_CASE("Dense kernels") {
+  // Small integers, so that every product is exact in floating point
+  const auto random_matrix = [](std::size_t nrows, std::size_t ncols, std::uint64_t seed) {
+    xmas::dense_matrix<double> A(nrows, ncols);
+    for (auto& x : A) {
+      seed = seed * 6364136223846793005u + 1442695040888963407u;
+      x = static_cast<double>(static_cast<int>((seed >> 33) % 19) - 9);
+    }
+    return A;
+  };
+
+  SUBCASE("GEMM") {
+    // Sizes that do not divide the tiles
+    using sizes = std::tuple<std::size_t, std::size_t, std::size_t>;
+    for (auto [m, k, n] : {sizes{3, 5, 2}, sizes{67, 131, 45}, sizes{40, 300, 270}}) {
+      const auto A = random_matrix(m, k, 1);
+      const auto B = random_matrix(k, n, 2);
+      const auto C = xmas::algebra::gemm(A, B);
+      const auto want = A * B;
+      REQUIRE_EQ(C.nrows(), m);
+      REQUIRE_EQ(C.ncols(), n);
+      CHECK(std::ranges::equal(C, want));
+    }
+  }
+
+  SUBCASE("GEMV") {
+    const auto A = random_matrix(150, 77, 3);
+    const auto x = random_matrix(77, 1, 4);
+    const xmas::basic_vector<double> u(x.begin(), x.end());
+
+    const auto y = A * u;
+    const auto want = A * x;
+    REQUIRE_EQ(y.size(), 150);
+    CHECK(std::ranges::equal(y, want));
+  }
+
+  SUBCASE("LU decomposition") {
+    const std::size_t n = 100;
+    const auto A = random_matrix(n, n, 5);
+    const auto x = random_matrix(n, 1, 6);
+    const auto b = A * x;
+
+    auto got = xmas::algebra::LUsolve(A, xmas::basic_vector<double>(b.begin(), b.end()));
+    REQUIRE(got.has_value());
+    for (std::size_t i = 0; i < n; ++i) {
+      CHECK_EQ((*got)[i], doctest::Approx(x[i][0]));
+    }
+
+    // A zero on the diagonal needs pivoting
+    xmas::dense_matrix<double> P(3, 3);
+    // clang-format off
+    P[0][0] = 0;     P[0][1] = 2;  P[0][2] = 1;
+    P[1][0] = 1;     P[1][1] = 1;  P[1][2] = 1;
+    P[2][0] = 4;     P[2][1] = 2;  P[2][2] = 0;
+    // clang-format on
+    const auto lu = xmas::algebra::lu_decompose(P);
+    CHECK_FALSE(lu.singular);
+    CHECK_EQ(lu.determinant(), doctest::Approx(6));
+
+    const auto y = lu.solve({3, 3, 6});
+    CHECK_EQ(y[0], doctest::Approx(1));
+    CHECK_EQ(y[1], doctest::Approx(1));
+    CHECK_EQ(y[2], doctest::Approx(1));
+
+    // Singular matrix
+    P[2][0] = 1;
+    P[2][1] = 3;
+    P[2][2] = 2;
+    CHECK_FALSE(xmas::algebra::LUsolve(P, xmas::basic_vector<double>{1, 2, 3}).has_value());
+    CHECK_EQ(xmas::algebra::lu_decompose(P).determinant(), 0);
+  }
+
+  SUBCASE("Exact LU decomposition") {
+    // Fractions, which must pivot on non-zero entries rather than on the largest ones
+    struct fraction {
+      std::int64_t num = 0;
+      std::int64_t den = 1;
+
+      fraction() = default;
+      fraction(std::int64_t n, std::int64_t d = 1) : num(n), den(d) {
+        const auto g = std::gcd(num, den) * (den < 0 ? -1 : 1);
+        num /= g;
+        den /= g;
+      }
+
+      fraction operator+(fraction o) const {
+        return {num * o.den + o.num * den, den * o.den};
+      }
+      fraction operator-(fraction o) const {
+        return {num * o.den - o.num * den, den * o.den};
+      }
+      fraction operator*(fraction o) const {
+        return {num * o.num, den * o.den};
+      }
+      fraction operator/(fraction o) const {
+        return {num * o.den, den * o.num};
+      }
+      fraction operator-() const {
+        return {-num, den};
+      }
+      fraction& operator*=(fraction o) {
+        return *this = *this * o;
+      }
+      fraction& operator/=(fraction o) {
+        return *this = *this / o;
+      }
+      bool operator==(fraction const&) const = default;
+    };
+
+    xmas::dense_matrix<fraction> A(3, 3);
+    // clang-format off
+    A[0][0] = 0;     A[0][1] = 3;  A[0][2] = 1;
+    A[1][0] = 2;     A[1][1] = 1;  A[1][2] = 0;
+    A[2][0] = 1;     A[2][1] = 0;  A[2][2] = 7;
+    // clang-format on
+
+    // x = (1/2, -1/3, 1)
+    const auto lu = xmas::algebra::lu_decompose(A);
+    REQUIRE_FALSE(lu.singular);
+    CHECK_EQ(lu.determinant(), fraction{-43});
+
+    const auto x = lu.solve({0, fraction{2, 3}, fraction{15, 2}});
+    CHECK_EQ(x[0], (fraction{1, 2}));
+    CHECK_EQ(x[1], (fraction{-1, 3}));
+    CHECK_EQ(x[2], fraction{1});
+  }
+
+  SUBCASE("Least squares") {
+    // Fit y = 2x + 1 through noisy points. The noise is orthogonal to both columns of A, so
+    // it cancels out.
+    xmas::dense_matrix<long double> A(4, 2);
+    xmas::basic_vector<long double> b(4);
+    const std::array<long double, 4> noise{0.5, -0.5, -0.5, 0.5};
+    for (std::size_t i = 0; i < 4; ++i) {
+      const auto x = static_cast<long double>(i);
+      A[i][0] = x;
+      A[i][1] = 1;
+      b[i] = 2 * x + 1 + noise[i];
+    }
+
+    const auto fit = xmas::algebra::LSQsolve(A, b);
+    REQUIRE(fit.has_value());
+    CHECK_EQ(static_cast<double>((*fit)[0]), doctest::Approx(2));
+    CHECK_EQ(static_cast<double>((*fit)[1]), doctest::Approx(1));
+
+    // Dependent columns
+    for (std::size_t i = 0; i < 4; ++i) {
+      A[i][0] = 2 * A[i][1];
+    }
+    CHECK_FALSE(xmas::algebra::LSQsolve(A, b).has_value());
+  }
+}
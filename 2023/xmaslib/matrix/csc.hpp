@@ -1,22 +1,33 @@
 #pragma once
 
 #include "../functional/functional.hpp"
+#include "../iota/iota.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <execution>
+#include <functional>
 #include <iterator>
+#include <numeric>
+#include <span>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 namespace xmas {
 
-// Compressed sparse column
+// Compressed sparse matrix. Entries are stored row by row, with their columns
+// sorted within each row. Use csc_matrix::builder to assemble large matrices:
+// set and init_row are O(nnz) per call.
 template <typename T> struct csc_matrix {
 private:
   std::size_t m_nrows, m_ncols;
 
+  // Number of consecutive rows handled by a single task in the products
+  static constexpr std::size_t block_size = 256;
+
   // Index in "cols" and "values" where that row begins
   std::vector<std::size_t> rows;
 
@@ -30,6 +41,7 @@ private:
 
 public:
   class iterator;
+  class builder;
 
   csc_matrix(std::size_t nrows, std::size_t ncols)
       : m_nrows(nrows), m_ncols(ncols), rows(nrows + 1, 0) {}
@@ -50,27 +62,28 @@ public:
     auto end = cols.begin() + static_cast<std::ptrdiff_t>(rows[row + 1]);
 
     auto it = std::find_if_not(begin, end, xmas::less_than(col));
+    auto idx = it - cols.begin();
     if (it == end || *it != col) {
       cols.insert(it, col);
-      data.insert(it, value);
-      ++rows[row + 1];
+      data.insert(data.begin() + idx, value);
+      std::for_each(rows.begin() + static_cast<std::ptrdiff_t>(row + 1),
+                    rows.end(), [](std::size_t &row_start) { ++row_start; });
     } else {
-      auto i = static_cast<std::size_t>(it - begin);
-      data[i] = value;
+      data[static_cast<std::size_t>(idx)] = value;
     }
   }
 
-  std::size_t get(std::size_t row, std::size_t col) const {
+  T get(std::size_t row, std::size_t col) const {
     assert(row < m_nrows);
     assert(col < m_ncols);
     auto begin = cols.begin() + static_cast<std::ptrdiff_t>(rows[row]);
     auto end = cols.begin() + static_cast<std::ptrdiff_t>(rows[row + 1]);
 
-    auto it = std::find_if_not(begin, end, xmas::less_than(col));
+    auto it = std::lower_bound(begin, end, col);
     if (it == end || *it != col) {
       return zero_value;
     }
-    return data[static_cast<std::size_t>(it - begin)];
+    return data[static_cast<std::size_t>(it - cols.begin())];
   }
 
   // init_row fills a new row in bulk.
@@ -101,7 +114,7 @@ public:
   // Using uint8_t because vector<bool> is BAD! (Causes races in the transform)
   std::vector<std::uint8_t> row_density() const {
     std::vector<std::uint8_t> r(m_nrows);
-    return std::transform(std::execution::par_unseq, rows.begin(),
+    std::transform(std::execution::par_unseq, rows.begin(),
                           rows.end() - 1, rows.begin() + 1, r.begin(),
                           [](std::size_t begin, std::size_t begin_next) {
                             return begin != begin_next ? 1 : 0;
@@ -121,47 +134,214 @@ public:
   auto &raw_columns() { return cols; }
   auto &raw_data() { return data; }
 
-  // shrink removes trainling rows and columns from the matrix
+  // shrink removes trailing empty rows and columns from the matrix
   void shrink() {
     auto it = std::adjacent_find(rows.rbegin(), rows.rend(),
                                  [](std::size_t ibegin, std::size_t jbegin) {
                                    return ibegin != jbegin;
                                  });
-    auto empty_trailing_rows = it - rows.rbegin();
-    m_nrows = static_cast<std::size_t>(rows.size() - empty_trailing_rows);
-    rows.resize(m_nrows);
-
-    if (m_nrows == 0) {
+    if (it == rows.rend()) {
+      m_nrows = 0;
+      m_ncols = 0;
+      rows.resize(1);
       return;
     }
 
+    auto empty_trailing_rows = static_cast<std::size_t>(it - rows.rbegin());
+    m_nrows = rows.size() - 1 - empty_trailing_rows;
+    rows.resize(m_nrows + 1);
+
     m_ncols = 1 + *std::max_element(cols.begin(), cols.end());
   }
 
+  // transposed returns the transpose of this matrix in O(nnz) with a counting
+  // sort. Its rows are the columns of this one, i.e. it is this matrix
+  // compressed by column.
+  csc_matrix transposed() const {
+    csc_matrix out(m_ncols, m_nrows, T(zero_value));
+
+    for (std::size_t col : cols) {
+      ++out.rows[col + 1];
+    }
+    std::inclusive_scan(out.rows.begin(), out.rows.end(), out.rows.begin());
+
+    out.cols.resize(cols.size());
+    out.data.resize(data.size());
+
+    std::vector<std::size_t> next(out.rows.begin(), out.rows.end() - 1);
+    for (std::size_t r = 0; r < m_nrows; ++r) {
+      for (std::size_t k = rows[r]; k < rows[r + 1]; ++k) {
+        const std::size_t dst = next[cols[k]]++;
+        out.cols[dst] = r;
+        out.data[dst] = data[k];
+      }
+    }
+
+    return out;
+  }
+
+  // multiply computes the sparse matrix-vector product y = A·x. Rows are
+  // processed in parallel in blocks of consecutive rows. The operations can be
+  // replaced to work over other semirings, e.g. (or, and) for reachability.
+  template <typename Add = std::plus<T>, typename Mul = std::multiplies<T>>
+  void multiply(std::span<const T> x, std::span<T> y, Add add = {},
+                Mul mul = {}) const {
+    assert(x.size() == m_ncols);
+    assert(y.size() == m_nrows);
+
+    for_each_block([&](std::size_t first, std::size_t last) {
+      for (std::size_t r = first; r < last; ++r) {
+        T acc = zero_value;
+        for (std::size_t k = rows[r]; k < rows[r + 1]; ++k) {
+          acc = add(acc, mul(data[k], x[cols[k]]));
+        }
+        y[r] = acc;
+      }
+    });
+  }
+
+  std::vector<T> operator*(std::vector<T> const &x) const {
+    std::vector<T> y(m_nrows, zero_value);
+    multiply(std::span<const T>(x), std::span<T>(y));
+    return y;
+  }
+
+  // multiply computes the sparse matrix-matrix product A·B. Every row of the
+  // output is computed by expanding the contributing products, sorting them by
+  // column and adding up the duplicates. Blocks of rows are computed in
+  // parallel and then concatenated.
+  template <typename Add = std::plus<T>, typename Mul = std::multiplies<T>>
+  csc_matrix multiply(csc_matrix const &B, Add add = {}, Mul mul = {}) const {
+    assert(m_ncols == B.m_nrows);
+
+    struct partial_product {
+      std::vector<std::size_t> row_sizes;
+      std::vector<std::size_t> cols;
+      std::vector<T> data;
+    };
+
+    std::vector<partial_product> blocks(n_blocks());
+    for_each_block([&](std::size_t first, std::size_t last) {
+      auto &out = blocks[first / block_size];
+      out.row_sizes.reserve(last - first);
+
+      std::vector<std::pair<std::size_t, T>> products;
+      for (std::size_t r = first; r < last; ++r) {
+        products.clear();
+        for (std::size_t k = rows[r]; k < rows[r + 1]; ++k) {
+          const std::size_t mid = cols[k];
+          for (std::size_t l = B.rows[mid]; l < B.rows[mid + 1]; ++l) {
+            products.emplace_back(B.cols[l], mul(data[k], B.data[l]));
+          }
+        }
+
+        std::sort(products.begin(), products.end(),
+                  [](auto const &a, auto const &b) { return a.first < b.first; });
+
+        const std::size_t row_begin = out.cols.size();
+        for (auto const &[col, value] : products) {
+          if (out.cols.size() != row_begin && out.cols.back() == col) {
+            out.data.back() = add(out.data.back(), value);
+            continue;
+          }
+          out.cols.push_back(col);
+          out.data.push_back(value);
+        }
+        out.row_sizes.push_back(out.cols.size() - row_begin);
+      }
+    });
+
+    csc_matrix C(m_nrows, B.m_ncols, T(zero_value));
+    auto row_it = C.rows.begin() + 1;
+    for (auto &block : blocks) {
+      row_it = std::copy(block.row_sizes.begin(), block.row_sizes.end(), row_it);
+      C.cols.insert(C.cols.end(), block.cols.begin(), block.cols.end());
+      C.data.insert(C.data.end(), block.data.begin(), block.data.end());
+    }
+    std::inclusive_scan(C.rows.begin(), C.rows.end(), C.rows.begin());
+
+    return C;
+  }
+
+  csc_matrix operator*(csc_matrix const &B) const { return multiply(B); }
+
 private:
   template <typename D>
   void insert_bulk(std::vector<D> &v, std::size_t pos,
                    std::vector<D> const &data) {
     assert(pos <= v.size());
+    v.insert(v.begin() + static_cast<std::ptrdiff_t>(pos), data.begin(),
+             data.end());
+  }
 
-    if (data.size() == 0) {
-      return;
+  std::size_t n_blocks() const {
+    return (m_nrows + block_size - 1) / block_size;
+  }
+
+  // for_each_block calls f(first_row, last_row) in parallel for every block of
+  // consecutive rows.
+  template <typename F> void for_each_block(F &&f) const {
+    xmas::views::iota<std::size_t> blocks(n_blocks());
+    std::for_each(std::execution::par, blocks.begin(), blocks.end(),
+                  [&](std::size_t b) {
+                    const std::size_t first = b * block_size;
+                    f(first, std::min(first + block_size, m_nrows));
+                  });
+  }
+
+public:
+  // builder collects (row, column, value) triplets in any order and compresses
+  // them into a matrix in O(nnz log nnz). If the same entry is added more than
+  // once, the last value wins.
+  class builder {
+  public:
+    builder(std::size_t nrows, std::size_t ncols)
+        : m_nrows(nrows), m_ncols(ncols) {}
+
+    void reserve(std::size_t nnz) { entries.reserve(nnz); }
+
+    void add(std::size_t row, std::size_t col, T value) {
+      assert(row < m_nrows);
+      assert(col < m_ncols);
+      entries.push_back(triplet{row, col, std::move(value)});
     }
 
-    if (v.size() == 0) {
-      v = data;
-      return;
+    [[nodiscard]] csc_matrix build(T zero_value = T{}) && {
+      std::stable_sort(std::execution::par, entries.begin(), entries.end(),
+                       [](triplet const &a, triplet const &b) {
+                         return std::tie(a.row, a.col) < std::tie(b.row, b.col);
+                       });
+
+      csc_matrix out(m_nrows, m_ncols, std::move(zero_value));
+      out.cols.reserve(entries.size());
+      out.data.reserve(entries.size());
+
+      for (std::size_t i = 0; i < entries.size(); ++i) {
+        auto &e = entries[i];
+        if (i + 1 < entries.size() && entries[i + 1].row == e.row &&
+            entries[i + 1].col == e.col) {
+          continue; // Overwritten by a later entry
+        }
+        ++out.rows[e.row + 1];
+        out.cols.push_back(e.col);
+        out.data.push_back(std::move(e.value));
+      }
+      std::inclusive_scan(out.rows.begin(), out.rows.end(), out.rows.begin());
+
+      entries.clear();
+      return out;
     }
 
-    v.resize(v.size() + data.size());
-    auto cp_begin = v.begin() + static_cast<std::ptrdiff_t>(pos);
-    auto cp_end = cp_begin + static_cast<std::ptrdiff_t>(data.size());
+  private:
+    struct triplet {
+      std::size_t row;
+      std::size_t col;
+      T value;
+    };
 
-    // Shift current data to the end
-    std::copy_backward(cp_begin, cp_end, cp_end);
-    // Copy new data
-    std::copy(data.begin(), data.end(), cp_begin);
-  }
+    std::size_t m_nrows, m_ncols;
+    std::vector<triplet> entries;
+  };
 
 public:
   class iterator {
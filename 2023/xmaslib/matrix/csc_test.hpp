@@ -0,0 +1,81 @@
+#pragma once
+
+#include <doctest/doctest.h>
+
+#include "csc.hpp"
+
+#include <cstddef>
+#include <vector>
+
+TEST_CASE("Sparse matrix") {
+
+  SUBCASE("Builder") {
+    xmas::csc_matrix<int>::builder b(3, 4);
+    b.add(2, 1, 7);
+    b.add(0, 3, 2);
+    b.add(0, 0, 1);
+    b.add(2, 1, 8); // Overwrites the previous (2, 1)
+
+    auto A = std::move(b).build();
+
+    REQUIRE_EQ(A.nrows(), 3);
+    REQUIRE_EQ(A.ncols(), 4);
+    REQUIRE_EQ(A.size(), 3);
+
+    CHECK_EQ(A.get(0, 0), 1);
+    CHECK_EQ(A.get(0, 3), 2);
+    CHECK_EQ(A.get(2, 1), 8);
+    CHECK_EQ(A.get(1, 1), 0);
+
+    CHECK_EQ(A.row_size(0), 2);
+    CHECK_EQ(A.row_size(1), 0);
+    CHECK_EQ(A.row_size(2), 1);
+
+    A.set(1, 2, 5);
+    A.set(0, 3, 9);
+    CHECK_EQ(A.size(), 4);
+    CHECK_EQ(A.get(1, 2), 5);
+    CHECK_EQ(A.get(0, 3), 9);
+    CHECK_EQ(A.get(2, 1), 8);
+  }
+
+  SUBCASE("Transpose") {
+    xmas::csc_matrix<int>::builder b(2, 3);
+    b.add(0, 1, 1);
+    b.add(1, 0, 2);
+    b.add(1, 2, 3);
+    const auto A = std::move(b).build();
+
+    const auto At = A.transposed();
+    REQUIRE_EQ(At.nrows(), 3);
+    REQUIRE_EQ(At.ncols(), 2);
+    CHECK_EQ(At.get(1, 0), 1);
+    CHECK_EQ(At.get(0, 1), 2);
+    CHECK_EQ(At.get(2, 1), 3);
+    CHECK_EQ(At.get(0, 0), 0);
+  }
+
+  SUBCASE("Products") {
+    // Path graph 0 -> 1 -> ... -> n-1, large enough to span several blocks
+    constexpr std::size_t n = 1000;
+    xmas::csc_matrix<std::size_t>::builder b(n, n);
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+      b.add(i, i + 1, i + 1);
+    }
+    const auto A = std::move(b).build();
+
+    std::vector<std::size_t> x(n, 1);
+    const auto y = A * x;
+    REQUIRE_EQ(y.size(), n);
+    CHECK_EQ(y[0], 1);
+    CHECK_EQ(y[500], 501);
+    CHECK_EQ(y[n - 1], 0);
+
+    const auto A2 = A * A;
+    REQUIRE_EQ(A2.size(), n - 2);
+    CHECK_EQ(A2.get(0, 2), 2);
+    CHECK_EQ(A2.get(300, 302), 301 * 302);
+    CHECK_EQ(A2.get(300, 301), 0);
+    CHECK_EQ(A2.row_size(n - 2), 0);
+  }
+}
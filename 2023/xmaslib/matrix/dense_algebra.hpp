@@ -1,14 +1,21 @@
 #pragma once
 
+#include "xmaslib/iota/iota.hpp"
 #include "xmaslib/log/log.hpp"
 #include "xmaslib/matrix/dense_matrix.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <concepts>
 #include <cstddef>
 #include <cstdlib>
 #include <functional>
 #include <numeric>
 #include <execution>
+#include <optional>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace xmas {
 
@@ -57,12 +64,147 @@ auto outter(basic_vector<T> const& lhs, basic_vector<T> const& rhs) {
   return outter<T>(lhs.data(), rhs.data());
 }
 
+namespace detail {
+
+// Tile sizes of the dense kernels. A tile of B of gemm_depth×gemm_width doubles fits in L2,
+// and the gemm_rows rows of A and C that are updated with it stay in L1.
+inline constexpr std::size_t gemm_rows = 32;
+inline constexpr std::size_t gemm_depth = 128;
+inline constexpr std::size_t gemm_width = 256;
+
+// Rows of A per parallel task of a matrix-vector product
+inline constexpr std::size_t gemv_rows = 64;
+
+// Below this many multiply-adds, a kernel is not worth splitting among threads
+inline constexpr std::size_t parallel_threshold = std::size_t{1} << 16;
+
+// Splits [0, n) into blocks and calls f(begin, end) on every one of them. The blocks run in
+// parallel if there are at least parallel_threshold multiply-adds of work to share.
+void for_each_block(std::size_t n, std::size_t block, std::size_t work, auto&& f) {
+  const xmas::views::iota<std::size_t> blocks((n + block - 1) / block);
+  const auto run = [&](std::size_t b) { f(b * block, std::min(n, (b + 1) * block)); };
+  if (work < parallel_threshold) {
+    std::for_each(blocks.begin(), blocks.end(), run);
+  } else {
+    std::for_each(std::execution::par, blocks.begin(), blocks.end(), run);
+  }
+}
+
+} // namespace detail
+
+// General matrix-matrix product C = A·B.
+//
+// The product is tiled so that a tile of B is reused by a whole block of rows of A before it
+// leaves the cache. The inner kernel updates four rows of C at once, so that every entry of B
+// is loaded once for all of them, and runs along rows of B and C, which are contiguous, so
+// that it vectorizes. Blocks of rows of C are computed in parallel.
+template <typename T>
+void gemm(dense_matrix<T> const& A, dense_matrix<T> const& B, dense_matrix<T>& C) {
+  assert(A.ncols() == B.nrows());
+  assert(C.nrows() == A.nrows() && C.ncols() == B.ncols());
+
+  const std::size_t K = A.ncols();
+  const std::size_t N = B.ncols();
+  T const* a = A.cdata().data();
+  T const* b = B.cdata().data();
+  T* c = C.data().data();
+
+  std::fill(C.begin(), C.end(), T{0});
+
+  // C[i..i+4)[j0..j1) += A[i..i+4)[k0..k1) · B[k0..k1)[j0..j1)
+  const auto kernel = [&](std::size_t i, std::size_t k0, std::size_t k1, std::size_t j0,
+                        std::size_t j1) {
+    T* c0 = c + i * N;
+    T* c1 = c0 + N;
+    T* c2 = c1 + N;
+    T* c3 = c2 + N;
+    for (std::size_t k = k0; k < k1; ++k) {
+      const T a0 = a[i * K + k];
+      const T a1 = a[(i + 1) * K + k];
+      const T a2 = a[(i + 2) * K + k];
+      const T a3 = a[(i + 3) * K + k];
+      T const* bk = b + k * N;
+      for (std::size_t j = j0; j < j1; ++j) {
+        const T y = bk[j];
+        c0[j] += a0 * y;
+        c1[j] += a1 * y;
+        c2[j] += a2 * y;
+        c3[j] += a3 * y;
+      }
+    }
+  };
+
+  // Same, for a single row
+  const auto tail = [&](std::size_t i, std::size_t k0, std::size_t k1, std::size_t j0,
+                      std::size_t j1) {
+    T* ci = c + i * N;
+    for (std::size_t k = k0; k < k1; ++k) {
+      const T aik = a[i * K + k];
+      T const* bk = b + k * N;
+      for (std::size_t j = j0; j < j1; ++j) {
+        ci[j] += aik * bk[j];
+      }
+    }
+  };
+
+  const auto rows = [&](std::size_t i0, std::size_t i1) {
+    for (std::size_t k0 = 0; k0 < K; k0 += detail::gemm_depth) {
+      const std::size_t k1 = std::min(K, k0 + detail::gemm_depth);
+      for (std::size_t j0 = 0; j0 < N; j0 += detail::gemm_width) {
+        const std::size_t j1 = std::min(N, j0 + detail::gemm_width);
+        std::size_t i = i0;
+        for (; i + 4 <= i1; i += 4) {
+          kernel(i, k0, k1, j0, j1);
+        }
+        for (; i < i1; ++i) {
+          tail(i, k0, k1, j0, j1);
+        }
+      }
+    }
+  };
+
+  detail::for_each_block(A.nrows(), detail::gemm_rows, A.nrows() * K * N, rows);
+}
+
+template <typename T>
+dense_matrix<T> gemm(dense_matrix<T> const& A, dense_matrix<T> const& B) {
+  dense_matrix<T> C(A.nrows(), B.ncols());
+  gemm(A, B, C);
+  return C;
+}
+
+// General matrix-vector product y = A·x. Blocks of rows of A are computed in parallel, and x
+// is small enough to stay in cache for all of them.
+template <typename T>
+void gemv(dense_matrix<T> const& A, basic_vector<T> const& x, basic_vector<T>& y) {
+  assert(A.ncols() == x.size());
+  assert(A.nrows() == y.size());
+
+  const std::size_t K = A.ncols();
+  T const* a = A.cdata().data();
+  T const* xs = x.cdata().data();
+  T* ys = y.data().data();
+
+  const auto rows = [&](std::size_t i0, std::size_t i1) {
+    for (std::size_t i = i0; i < i1; ++i) {
+      ys[i] = std::transform_reduce(std::execution::unseq, a + i * K, a + (i + 1) * K, xs, T{0});
+    }
+  };
+
+  detail::for_each_block(A.nrows(), detail::gemv_rows, A.nrows() * K, rows);
+}
+
 template <typename T, typename Matrix, typename Vector>
 basic_vector<T> MV_mult(Matrix const& A, Vector const& u) {
   assert(A.ncols() == u.size());
   basic_vector<T> out(A.nrows());
-  std::transform(std::execution::par_unseq, A.crows().begin(), A.crows().end(), out.begin(),
-    [&u](auto const& row) { return inner(row, u); });
+  if constexpr (std::same_as<Matrix, dense_matrix<T>> && std::same_as<Vector, basic_vector<T>>) {
+    gemv(A, u, out);
+  } else {
+    const xmas::views::iota<std::size_t> rows(A.nrows());
+    std::for_each(std::execution::par_unseq, rows.begin(), rows.end(),
+      [&](std::size_t r) { out[r] = inner(A.row(r), u); });
+  }
   return out;
 }
 }
@@ -219,5 +361,153 @@ bool CGsolve(is_matrix<T> auto const& A, xmas::basic_vector<T> const& b, xmas::b
   return false;
 }
 
+/*
+lu_decomposition is the factorization PA = LU of a square matrix, with partial pivoting.
+
+L (below the diagonal, with an implicit unit diagonal) and U (on and above it) share the same
+matrix. Row i of PA is row permutation[i] of A.
+*/
+template <typename T>
+struct lu_decomposition {
+  dense_matrix<T> LU;
+  std::vector<std::size_t> permutation;
+  bool odd;      // Whether the permutation is made of an odd number of swaps
+  bool singular; // Whether A is singular, in which case solve() cannot be used
+
+  [[nodiscard]] T determinant() const {
+    if (singular) {
+      return T{0};
+    }
+    T det{1};
+    for (std::size_t i = 0; i < LU.nrows(); ++i) {
+      det *= LU[i][i];
+    }
+    return odd ? -det : det;
+  }
+
+  // Solves the system Ax=b
+  [[nodiscard]] basic_vector<T> solve(basic_vector<T> const& b) const {
+    assert(!singular);
+    assert(b.size() == LU.nrows());
+    const std::size_t N = LU.nrows();
+    T const* lu = LU.cdata().data();
+
+    // Forward substitution with L, then backward substitution with U
+    basic_vector<T> x(N);
+    T* xs = x.data().data();
+    for (std::size_t i = 0; i < N; ++i) {
+      T const* row = lu + i * N;
+      const T known = std::transform_reduce(std::execution::unseq, row, row + i, xs, T{0});
+      xs[i] = b[permutation[i]] - known;
+    }
+    for (std::size_t i = N; i-- > 0;) {
+      T const* row = lu + i * N;
+      const T known = std::transform_reduce(
+        std::execution::unseq, row + i + 1, row + N, xs + i + 1, T{0});
+      xs[i] = (xs[i] - known) / row[i];
+    }
+    return x;
+  }
+};
+
+// LU decomposition with partial pivoting. Floating point types pivot on the largest entry of
+// every column, to limit rounding errors, and exact types such as rationals on the first
+// non-zero one. The rows below every pivot are updated in parallel.
+template <typename T>
+lu_decomposition<T> lu_decompose(dense_matrix<T> A) {
+  static_assert(!std::is_integral_v<T>, "LU needs exact division: use a rational type instead");
+  assert(A.nrows() == A.ncols()); // A must be square
+
+  const std::size_t N = A.nrows();
+  T* a = A.data().data();
+
+  std::vector<std::size_t> permutation(N);
+  std::iota(permutation.begin(), permutation.end(), std::size_t{0});
+  bool odd = false;
+  bool singular = false;
+
+  for (std::size_t k = 0; k < N; ++k) {
+    std::size_t p = k;
+    if constexpr (std::is_floating_point_v<T>) {
+      for (std::size_t i = k + 1; i < N; ++i) {
+        if (std::abs(a[i * N + k]) > std::abs(a[p * N + k])) {
+          p = i;
+        }
+      }
+    } else {
+      while (p + 1 < N && a[p * N + k] == T{0}) {
+        ++p;
+      }
+    }
+
+    if (a[p * N + k] == T{0}) {
+      singular = true;
+      continue;
+    }
+
+    if (p != k) {
+      std::swap_ranges(a + k * N, a + (k + 1) * N, a + p * N);
+      std::swap(permutation[k], permutation[p]);
+      odd = !odd;
+    }
+
+    // Eliminate the column below the pivot
+    const T pivot = a[k * N + k];
+    T const* uk = a + k * N;
+    const auto rows = [&](std::size_t i0, std::size_t i1) {
+      for (std::size_t i = k + 1 + i0; i < k + 1 + i1; ++i) {
+        T* ai = a + i * N;
+        ai[k] /= pivot;
+        const T l = ai[k];
+        if (l == T{0}) {
+          continue;
+        }
+        std::transform(std::execution::unseq, ai + k + 1, ai + N, uk + k + 1, ai + k + 1,
+          [l](T x, T u) { return x - l * u; });
+      }
+    };
+
+    const std::size_t below = N - k - 1;
+    detail::for_each_block(below, detail::gemm_rows, below * below, rows);
+  }
+
+  return {
+    .LU = std::move(A),
+    .permutation = std::move(permutation),
+    .odd = odd,
+    .singular = singular,
+  };
+}
+
+// Solve system Ax=b with LU decomposition. Returns nothing if A is singular.
+template <typename T>
+std::optional<basic_vector<T>> LUsolve(dense_matrix<T> const& A, basic_vector<T> const& b) {
+  assert(A.nrows() == b.size()); // b must be the same size as A
+  auto lu = lu_decompose(A);
+  if (lu.singular) {
+    return {};
+  }
+  return {lu.solve(b)};
+}
+
+// Find the x that minimizes |Ax-b|, where A has at least as many rows as columns, by solving
+// the normal equations AᵀAx = Aᵀb with LU decomposition. Returns nothing if the columns of A
+// are linearly dependent.
+//
+// The normal equations square the condition number of A. This is harmless for exact types and
+// for small, well-conditioned systems, which are the ones these puzzles have.
+template <typename T>
+std::optional<basic_vector<T>> LSQsolve(dense_matrix<T> const& A, basic_vector<T> const& b) {
+  assert(A.nrows() >= A.ncols()); // The system must not be underdetermined
+  assert(A.nrows() == b.size());  // b must have as many rows as A
+
+  dense_matrix<T> At = A;
+  At.transpose();
+
+  basic_vector<T> Atb(A.ncols());
+  gemv(At, b, Atb);
+  return LUsolve(gemm(At, A), Atb);
+}
+
 }
 }
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "bench/bench.hpp"
+
+#include "dense_algebra.hpp"
+#include "dense_matrix.hpp"
+#include "dense_vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+
+namespace dense_algebra_bench {
+
+// Pseudo-random matrix with small integer entries, and a heavy diagonal so that it is well
+// conditioned when square
+inline xmas::dense_matrix<double> make_matrix(std::size_t nrows, std::size_t ncols) {
+  xmas::dense_matrix<double> A(nrows, ncols);
+  std::uint64_t state = 42;
+  for (auto& x : A) {
+    state = state * 6364136223846793005u + 1442695040888963407u;
+    x = static_cast<double>(static_cast<int>((state >> 33) % 19) - 9);
+  }
+  for (std::size_t i = 0; i < std::min(nrows, ncols); ++i) {
+    A[i][i] += static_cast<double>(10 * ncols);
+  }
+  return A;
+}
+
+// Row by row matrix-vector product, as a reference
+inline xmas::basic_vector<double> naive_gemv(
+  xmas::dense_matrix<double> const& A, xmas::basic_vector<double> const& x) {
+  xmas::basic_vector<double> y(A.nrows(), 0.0);
+  for (std::size_t i = 0; i < A.nrows(); ++i) {
+    for (std::size_t j = 0; j < A.ncols(); ++j) {
+      y[i] += A[i][j] * x[j];
+    }
+  }
+  return y;
+}
+
+// Entry (i, j) of the product AB, as a reference for sizes where the full naive product is too
+// slow
+inline double naive_entry(xmas::dense_matrix<double> const& A, xmas::dense_matrix<double> const& B,
+  std::size_t i, std::size_t j) {
+  double sum = 0;
+  for (std::size_t k = 0; k < A.ncols(); ++k) {
+    sum += A[i][k] * B[k][j];
+  }
+  return sum;
+}
+
+// Checks the tiled product against the naive one. Above 1024 only a sample of entries is
+// compared, since the full naive product takes many seconds.
+inline bool gemm_agrees(xmas::dense_matrix<double> const& A, xmas::dense_matrix<double> const& B) {
+  const auto C = xmas::algebra::gemm(A, B);
+  if (A.nrows() <= 1024) {
+    return std::ranges::equal(C, A * B);
+  }
+
+  std::uint64_t state = 7;
+  for (int sample = 0; sample < 256; ++sample) {
+    state = state * 6364136223846793005u + 1442695040888963407u;
+    const std::size_t i = (state >> 33) % C.nrows();
+    const std::size_t j = (state >> 13) % C.ncols();
+    if (C[i][j] != naive_entry(A, B, i, j)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline const bench::registration registration("dense_algebra", [] {
+  for (std::size_t n : {64, 256, 1024, 2048}) {
+    const auto A = make_matrix(n, n);
+    const auto B = make_matrix(n, n);
+    const xmas::basic_vector<double> x(n, 1.0);
+
+    if (!gemm_agrees(A, B)) {
+      xlog::error("dense_algebra: products disagree for n={}", n);
+      return;
+    }
+
+    // The naive product reads B column-wise. Above 1024 a single run takes many seconds.
+    if (n <= 1024) {
+      bench::report("dense_algebra", std::format("naive gemm {}", n), bench::run([&] {
+        bench::do_not_optimize((A * B).data().data());
+      }));
+    }
+
+    xmas::dense_matrix<double> C(n, n);
+    bench::report("dense_algebra", std::format("tiled gemm {}", n), bench::run([&] {
+      xmas::algebra::gemm(A, B, C);
+      bench::do_not_optimize(C.data().data());
+    }));
+
+    bench::report("dense_algebra", std::format("naive gemv {}", n), bench::run([&] {
+      bench::do_not_optimize(naive_gemv(A, x)[0]);
+    }));
+
+    xmas::basic_vector<double> y(n);
+    bench::report("dense_algebra", std::format("blocked gemv {}", n), bench::run([&] {
+      xmas::algebra::gemv(A, x, y);
+      bench::do_not_optimize(y[0]);
+    }));
+
+    bench::report("dense_algebra", std::format("LU solve {}", n), bench::run([&] {
+      bench::do_not_optimize(xmas::algebra::LUsolve(A, x).has_value());
+    }));
+  }
+});
+
+} // namespace dense_algebra_bench
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "text_matrix.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace xmas {
+
+/*
+padded_grid is a row-major grid surrounded by a one-cell border of sentinel values.
+
+Cells are addressed by their flat index in the padded storage, and moving to a
+neighbour is a single addition of a precomputed offset. Every interior cell has
+four valid neighbours, so traversals need no bounds checks: walking onto the
+border is detected by its sentinel value.
+
+```c++
+xmas::padded_grid<char> map(text, '#');
+for (auto dir : map.directions) {
+  auto next = map.neighbour(pos, dir);
+  if (map[next] != '#') {
+    visit(next);
+  }
+}
+```
+*/
+template <typename T>
+class padded_grid {
+public:
+  enum direction : std::uint8_t {
+    up,
+    right,
+    down,
+    left,
+  };
+
+  static constexpr std::array<direction, 4> directions{up, right, down, left};
+
+  padded_grid(std::size_t nrows, std::size_t ncols, T const& border, T const& fill = T{}) :
+      n_rows(nrows), n_cols(ncols), m_stride(ncols + 2), m_data((nrows + 2) * m_stride, fill),
+      m_offsets{std::size_t{0} - m_stride, 1, m_stride, std::size_t{0} - 1} {
+    fill_border(border);
+  }
+
+  // Builds a grid with the contents of a text matrix
+  padded_grid(views::text_matrix const& text, T const& border) :
+      padded_grid(text.nrows(), text.ncols(), border) {
+    for (std::size_t r = 0; r < n_rows; ++r) {
+      auto line = text.line(r);
+      std::copy(line.begin(), line.end(), row(r).begin());
+    }
+  }
+
+  [[nodiscard]] std::size_t nrows() const noexcept {
+    return n_rows;
+  }
+
+  [[nodiscard]] std::size_t ncols() const noexcept {
+    return n_cols;
+  }
+
+  // Distance between vertically adjacent cells
+  [[nodiscard]] std::size_t stride() const noexcept {
+    return m_stride;
+  }
+
+  // Size of the storage, including the border
+  [[nodiscard]] std::size_t size() const noexcept {
+    return m_data.size();
+  }
+
+  // Flat index of the interior cell at (row, col)
+  [[nodiscard]] std::size_t index(std::size_t row, std::size_t col) const noexcept {
+    assert(row < n_rows);
+    assert(col < n_cols);
+    return (row + 1) * m_stride + col + 1;
+  }
+
+  // Row and column of the interior cell at a flat index
+  [[nodiscard]] std::pair<std::size_t, std::size_t> coords(std::size_t idx) const noexcept {
+    return {idx / m_stride - 1, idx % m_stride - 1};
+  }
+
+  [[nodiscard]] std::size_t neighbour(std::size_t idx, direction d) const noexcept {
+    return idx + m_offsets[d];
+  }
+
+  [[nodiscard]] static constexpr direction opposite(direction d) noexcept {
+    return direction((d + 2) % 4);
+  }
+
+  [[nodiscard]] T& operator[](std::size_t idx) noexcept {
+    assert(idx < m_data.size());
+    return m_data[idx];
+  }
+
+  [[nodiscard]] T const& operator[](std::size_t idx) const noexcept {
+    assert(idx < m_data.size());
+    return m_data[idx];
+  }
+
+  [[nodiscard]] T& at(std::size_t row, std::size_t col) noexcept {
+    return m_data[index(row, col)];
+  }
+
+  [[nodiscard]] T const& at(std::size_t row, std::size_t col) const noexcept {
+    return m_data[index(row, col)];
+  }
+
+  // The interior cells of a row
+  [[nodiscard]] std::span<T> row(std::size_t r) noexcept {
+    return {m_data.data() + index(r, 0), n_cols};
+  }
+
+  [[nodiscard]] std::span<const T> row(std::size_t r) const noexcept {
+    return {m_data.data() + index(r, 0), n_cols};
+  }
+
+  // The storage, including the border
+  [[nodiscard]] std::vector<T>& data() noexcept {
+    return m_data;
+  }
+
+  [[nodiscard]] std::vector<T> const& data() const noexcept {
+    return m_data;
+  }
+
+private:
+  std::size_t n_rows;
+  std::size_t n_cols;
+  std::size_t m_stride;
+  std::vector<T> m_data;
+
+  // Offsets to the neighbours, indexed by direction. Negative offsets rely on
+  // unsigned wrap-around.
+  std::array<std::size_t, 4> m_offsets;
+
+  void fill_border(T const& border) {
+    const std::size_t last_row = (n_rows + 1) * m_stride;
+    for (std::size_t c = 0; c < m_stride; ++c) {
+      m_data[c] = border;
+      m_data[last_row + c] = border;
+    }
+    for (std::size_t r = 1; r <= n_rows; ++r) {
+      m_data[r * m_stride] = border;
+      m_data[r * m_stride + n_cols + 1] = border;
+    }
+  }
+};
+
+} // namespace xmas
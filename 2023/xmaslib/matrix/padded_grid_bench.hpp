@@ -0,0 +1,110 @@
+#pragma once
+
+#include "bench/bench.hpp"
+
+#include "padded_grid.hpp"
+#include "text_matrix.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace padded_grid_bench {
+
+// make_maze generates a pseudo-random n×n map where roughly one in five cells is a rock
+inline std::string make_maze(std::size_t n) {
+  std::string text;
+  text.reserve(n * (n + 1));
+
+  std::uint64_t state = 42;
+  for (std::size_t r = 0; r < n; ++r) {
+    for (std::size_t c = 0; c < n; ++c) {
+      state = state * 6364136223846793005u + 1442695040888963407u;
+      text.push_back((state >> 33) % 5 == 0 ? '#' : '.');
+    }
+    text.push_back('\n');
+  }
+
+  text[(n / 2) * (n + 1) + n / 2] = '.'; // Ensure the center is free
+  return text;
+}
+
+// Counts the cells reachable from (row, col), with bounds checks on every step
+inline std::size_t bfs(xmas::views::text_matrix const& map, std::size_t row, std::size_t col) {
+  std::vector<std::uint8_t> visited(map.nrows() * map.ncols(), 0);
+  std::vector<std::pair<std::size_t, std::size_t>> queue{{row, col}};
+  visited[row * map.ncols() + col] = 1;
+
+  const auto visit = [&](std::size_t r, std::size_t c) {
+    auto& v = visited[r * map.ncols() + c];
+    if (v == 0 && map.at(r, c) != '#') {
+      v = 1;
+      queue.emplace_back(r, c);
+    }
+  };
+
+  for (std::size_t head = 0; head < queue.size(); ++head) {
+    const auto [r, c] = queue[head];
+    if (r != 0) {
+      visit(r - 1, c);
+    }
+    if (r + 1 < map.nrows()) {
+      visit(r + 1, c);
+    }
+    if (c != 0) {
+      visit(r, c - 1);
+    }
+    if (c + 1 < map.ncols()) {
+      visit(r, c + 1);
+    }
+  }
+
+  return queue.size();
+}
+
+// Counts the cells reachable from start. The rock border makes bounds checks unnecessary.
+inline std::size_t bfs(xmas::padded_grid<char> const& map, std::size_t start) {
+  std::vector<std::uint8_t> visited(map.size(), 0);
+  std::vector<std::size_t> queue{start};
+  visited[start] = 1;
+
+  for (std::size_t head = 0; head < queue.size(); ++head) {
+    const auto pos = queue[head];
+    for (auto dir : map.directions) {
+      const auto next = map.neighbour(pos, dir);
+      if (visited[next] == 0 && map[next] != '#') {
+        visited[next] = 1;
+        queue.push_back(next);
+      }
+    }
+  }
+
+  return queue.size();
+}
+
+inline const bench::registration registration("padded_grid_bfs", [] {
+  for (std::size_t n : {64, 512, 2048}) {
+    auto text = make_maze(n);
+    const xmas::views::text_matrix text_map(text);
+    const xmas::padded_grid<char> padded_map(text_map, '#');
+    const std::size_t center = n / 2;
+
+    if (bfs(text_map, center, center) != bfs(padded_map, padded_map.index(center, center))) {
+      xlog::error("padded_grid_bfs: traversals disagree for n={}", n);
+      return;
+    }
+
+    bench::report("padded_grid_bfs", std::format("text_matrix {}", n), bench::run([&] {
+      bench::do_not_optimize(bfs(text_map, center, center));
+    }));
+
+    bench::report("padded_grid_bfs", std::format("padded_grid {}", n), bench::run([&] {
+      bench::do_not_optimize(bfs(padded_map, padded_map.index(center, center)));
+    }));
+  }
+});
+
+} // namespace padded_grid_bench
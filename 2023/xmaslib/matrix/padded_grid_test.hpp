@@ -0,0 +1,44 @@
+#pragma once
+
+#include <doctest/doctest.h>
+
+#include "padded_grid.hpp"
+#include "text_matrix.hpp"
+
+#include <string>
+
+TEST_CASE("Padded grid") {
+  std::string text = "abcd\nefgh\nijkl\n";
+  xmas::views::text_matrix tm(text);
+
+  REQUIRE_EQ(tm.nrows(), 3);
+  REQUIRE_EQ(tm.ncols(), 4);
+  CHECK_EQ(tm.line(2), "ijkl");
+
+  xmas::padded_grid<char> grid(tm, '#');
+  REQUIRE_EQ(grid.nrows(), 3);
+  REQUIRE_EQ(grid.ncols(), 4);
+  REQUIRE_EQ(grid.size(), 5 * 6);
+
+  CHECK_EQ(grid.at(0, 0), 'a');
+  CHECK_EQ(grid.at(1, 2), 'g');
+  CHECK_EQ(grid.at(2, 3), 'l');
+
+  const auto g = grid.index(1, 2);
+  CHECK_EQ(grid.coords(g).first, 1);
+  CHECK_EQ(grid.coords(g).second, 2);
+  CHECK_EQ(grid[grid.neighbour(g, grid.up)], 'c');
+  CHECK_EQ(grid[grid.neighbour(g, grid.down)], 'k');
+  CHECK_EQ(grid[grid.neighbour(g, grid.left)], 'f');
+  CHECK_EQ(grid[grid.neighbour(g, grid.right)], 'h');
+  CHECK_EQ(grid.opposite(grid.up), grid.down);
+  CHECK_EQ(grid.opposite(grid.left), grid.right);
+
+  // Stepping off the interior lands on the border
+  const auto a = grid.index(0, 0);
+  CHECK_EQ(grid[grid.neighbour(a, grid.up)], '#');
+  CHECK_EQ(grid[grid.neighbour(a, grid.left)], '#');
+  const auto l = grid.index(2, 3);
+  CHECK_EQ(grid[grid.neighbour(l, grid.down)], '#');
+  CHECK_EQ(grid[grid.neighbour(l, grid.right)], '#');
+}
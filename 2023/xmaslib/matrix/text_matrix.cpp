@@ -1,14 +1,91 @@
 #include "text_matrix.hpp"
 #include "../log/log.hpp"
 
+#include "../iota/iota.hpp"
+
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <format>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
 namespace xmas {
 namespace views {
 
+namespace {
+
+// Side of the square tiles that are transposed at once. A tile of the source and one of the
+// destination fit in L1 together.
+constexpr std::size_t tile = 64;
+
+// Matrices smaller than this many bytes are transposed in a single thread
+constexpr std::size_t parallel_threshold = std::size_t{1} << 20;
+
+// Swaps the bits of lo selected by mask with the bits of hi that are `shift` positions below
+template <unsigned shift, std::uint64_t mask>
+void swap_across(std::uint64_t& lo, std::uint64_t& hi) noexcept {
+  const std::uint64_t t = (lo ^ (hi << shift)) & mask;
+  lo ^= t;
+  hi ^= t >> shift;
+}
+
+// Transposes an 8×8 block of bytes, with one row per word, by swapping 1×1, then 2×2, then
+// 4×4 sub-blocks across the diagonal. Every step works on whole words, as if they were SIMD
+// registers of eight lanes. Byte j of every row must be its lane j, which only holds for words
+// loaded on little-endian targets: transpose_tile does not call it on the others.
+void transpose_8x8(std::array<std::uint64_t, 8>& x) noexcept {
+  for (std::size_t i = 0; i < 8; i += 2) {
+    swap_across<8, 0xFF00FF00FF00FF00>(x[i], x[i + 1]);
+  }
+  for (std::size_t i : {0, 1, 4, 5}) {
+    swap_across<16, 0xFFFF0000FFFF0000>(x[i], x[i + 2]);
+  }
+  for (std::size_t i = 0; i < 4; ++i) {
+    swap_across<32, 0xFFFFFFFF00000000>(x[i], x[i + 4]);
+  }
+}
+
+// Transposes the nrows×ncols bytes at src into dst. Rows are src_stride and dst_stride bytes
+// apart, respectively.
+void transpose_tile(char const* src, std::size_t src_stride, char* dst, std::size_t dst_stride,
+  std::size_t nrows, std::size_t ncols) {
+  std::size_t r = 0;
+  if constexpr (std::endian::native == std::endian::little) {
+    for (; r + 8 <= nrows; r += 8) {
+      std::size_t c = 0;
+      for (; c + 8 <= ncols; c += 8) {
+        std::array<std::uint64_t, 8> x;
+        for (std::size_t i = 0; i < 8; ++i) {
+          std::memcpy(&x[i], src + (r + i) * src_stride + c, 8);
+        }
+        transpose_8x8(x);
+        for (std::size_t i = 0; i < 8; ++i) {
+          std::memcpy(dst + (c + i) * dst_stride + r, &x[i], 8);
+        }
+      }
+      for (; c < ncols; ++c) {
+        for (std::size_t i = 0; i < 8; ++i) {
+          dst[c * dst_stride + r + i] = src[(r + i) * src_stride + c];
+        }
+      }
+    }
+  }
+
+  for (; r < nrows; ++r) {
+    for (std::size_t c = 0; c < ncols; ++c) {
+      dst[c * dst_stride + r] = src[r * src_stride + c];
+    }
+  }
+}
+
+} // namespace
+
 std::pair<std::size_t, std::size_t> text_matrix::dimensions(std::string_view input) {
   const std::size_t ncols =
     1 + std::size_t(std::find(input.cbegin(), input.cend(), '\n') - input.cbegin());
@@ -26,14 +103,14 @@ text_matrix::text_matrix(std::string& data) : text(data) {
 
 view<std::string::iterator> text_matrix::row(std::size_t i) {
   assert(i < n_rows);
-  const std::size_t pos = i * (n_rows + 1);
+  const std::size_t pos = i * (n_cols + 1);
   return {text.begin() + static_cast<std::ptrdiff_t>(pos),
     text.begin() + static_cast<std::ptrdiff_t>(pos + n_cols)};
 }
 
 std::string_view text_matrix::line(std::size_t i) const {
   assert(i < n_rows);
-  const std::size_t pos = i * (n_rows + 1);
+  const std::size_t pos = i * (n_cols + 1);
   return {text.begin() + static_cast<std::ptrdiff_t>(pos),
     text.begin() + static_cast<std::ptrdiff_t>(pos + n_cols)};
 }
@@ -55,5 +132,69 @@ char& text_matrix::at(std::size_t i, std::size_t j) {
   return text[i * (n_cols + 1) + j];
 }
 
+void text_matrix::transpose_into(text_matrix& dst) const {
+  if (dst.n_rows != n_cols || (dst.n_rows != 0 && dst.n_cols != n_rows)) {
+    throw std::runtime_error(std::format(
+      "xmas::views::text_matrix::transpose_into: cannot transpose {}x{} into {}x{}", n_rows,
+      n_cols, dst.n_rows, dst.n_cols));
+  }
+
+  const std::size_t src_stride = n_cols + 1;
+  const std::size_t dst_stride = dst.n_cols + 1;
+  char const* src = text.data();
+  char* out = dst.text.data();
+
+  // Every band of rows of this matrix becomes a band of columns of dst, so bands do not
+  // interfere with each other
+  const xmas::views::iota<std::size_t> bands((n_rows + tile - 1) / tile);
+  const auto transpose_band = [&](std::size_t band) {
+    const std::size_t r = band * tile;
+    for (std::size_t c = 0; c < n_cols; c += tile) {
+      transpose_tile(src + r * src_stride + c, src_stride, out + c * dst_stride + r, dst_stride,
+        std::min(tile, n_rows - r), std::min(tile, n_cols - c));
+    }
+  };
+
+  if (n_rows * n_cols < parallel_threshold) {
+    std::for_each(bands.begin(), bands.end(), transpose_band);
+  } else {
+    std::for_each(std::execution::par, bands.begin(), bands.end(), transpose_band);
+  }
+}
+
+std::string text_matrix::transposed() const {
+  std::string out = blank(n_cols, n_rows);
+  text_matrix t(out);
+  transpose_into(t);
+  return out;
+}
+
+std::string text_matrix::blank(std::size_t nrows, std::size_t ncols, char fill) {
+  std::string out(nrows * (ncols + 1), fill);
+  for (std::size_t r = 0; r < nrows; ++r) {
+    out[r * (ncols + 1) + ncols] = '\n';
+  }
+  return out;
+}
+
+column_major::column_major(text_matrix& matrix) :
+    matrix(matrix), text(text_matrix::blank(matrix.ncols(), matrix.nrows())), transposed(text) {
+}
+
+text_matrix& column_major::cols() {
+  if (stale) {
+    matrix.transpose_into(transposed);
+    stale = false;
+  }
+  return transposed;
+}
+
+void column_major::commit() {
+  if (stale) {
+    return; // The copy was not read since the matrix changed, so there is nothing new in it
+  }
+  transposed.transpose_into(matrix);
+}
+
 } // namespace views
 } // namespace xmas
\ No newline at end of file
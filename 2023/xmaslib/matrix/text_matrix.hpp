@@ -3,7 +3,9 @@
 #include "../stride/stride.hpp"
 #include "../view/view.hpp"
 
+#include <cstddef>
 #include <ranges>
+#include <string>
 #include <string_view>
 #include <utility>
 
@@ -60,6 +62,16 @@ struct text_matrix {
            std::ranges::views::transform([this](std::size_t c) { return col(c); });
   }
 
+  // Writes the transpose of this matrix into dst, which must have as many rows as this one
+  // has columns and vice versa. Columns become contiguous rows in dst.
+  void transpose_into(text_matrix& dst) const;
+
+  // Returns the text of the transpose of this matrix
+  [[nodiscard]] std::string transposed() const;
+
+  // Returns the text of an empty nrows×ncols matrix, to be filled in
+  [[nodiscard]] static std::string blank(std::size_t nrows, std::size_t ncols, char fill = '.');
+
 private:
   std::size_t n_rows;
   std::size_t n_cols;
@@ -68,5 +80,45 @@ private:
   static std::pair<std::size_t, std::size_t> dimensions(std::string_view input);
 };
 
+/*
+column_major is a transposed copy of a text_matrix, where every column of the matrix is a
+contiguous row. Algorithms that walk columns can then scan rows instead of jumping a whole line
+ahead on every step.
+
+The copy is rebuilt lazily: after the matrix is modified, invalidate() the copy and it will be
+transposed again the next time it is read. Modifications to the copy are written back into
+the matrix with commit().
+
+```c++
+xmas::views::column_major shadow(matrix);
+tilt_rows(shadow.cols()); // Tilts the columns of the matrix
+shadow.commit();
+```
+*/
+class column_major {
+public:
+  explicit column_major(text_matrix& matrix);
+
+  column_major(column_major const&) = delete;
+  column_major& operator=(column_major const&) = delete;
+
+  // The columns of the matrix, as rows
+  [[nodiscard]] text_matrix& cols();
+
+  // Marks the copy as outdated, after the matrix has been modified
+  void invalidate() noexcept {
+    stale = true;
+  }
+
+  // Writes the copy back into the matrix
+  void commit();
+
+private:
+  text_matrix& matrix;
+  std::string text;
+  text_matrix transposed;
+  bool stale = true;
+};
+
 } // namespace views
 } // namespace xmas
\ No newline at end of file
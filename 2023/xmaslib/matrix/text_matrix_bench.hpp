@@ -0,0 +1,103 @@
+#pragma once
+
+#include "bench/bench.hpp"
+
+#include "text_matrix.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string>
+
+namespace text_matrix_bench {
+
+// make_platform generates a pseudo-random n×n map of rocks: one in five cells is a fixed rock
+// ('#') and one in five a rolling one ('O')
+inline std::string make_platform(std::size_t n) {
+  std::string text = xmas::views::text_matrix::blank(n, n);
+  std::uint64_t state = 42;
+  for (char& ch : text) {
+    state = state * 6364136223846793005u + 1442695040888963407u;
+    if (ch != '\n') {
+      const auto roll = (state >> 33) % 5;
+      ch = roll == 0 ? '#' : roll == 1 ? 'O' : '.';
+    }
+  }
+  return text;
+}
+
+// Rolls every rock in the line towards its beginning, as in day 14
+template <typename Line>
+void tilt(Line line) {
+  auto fall_to = line.begin();
+  for (auto it = line.begin(); it != line.end(); ++it) {
+    if (*it == '#') {
+      fall_to = it + 1;
+    } else if (*it == 'O') {
+      *it = '.';
+      *fall_to = 'O';
+      ++fall_to;
+    }
+  }
+}
+
+inline const bench::registration registration("text_matrix_columns", [] {
+  for (std::size_t n : {1000, 10000}) {
+    auto text = make_platform(n);
+    xmas::views::text_matrix matrix(text);
+
+    auto naive_text = xmas::views::text_matrix::blank(n, n);
+    xmas::views::text_matrix naive(naive_text);
+    bench::report("text_matrix_columns", std::format("strided transp {}", n), bench::run([&] {
+      for (std::size_t c = 0; c < n; ++c) {
+        auto col = matrix.col(c);
+        auto row = naive.row(c);
+        std::copy(col.begin(), col.end(), row.begin());
+      }
+      bench::do_not_optimize(naive_text.data());
+    }));
+
+    auto blocked_text = xmas::views::text_matrix::blank(n, n);
+    xmas::views::text_matrix blocked(blocked_text);
+    bench::report("text_matrix_columns", std::format("blocked transp {}", n), bench::run([&] {
+      matrix.transpose_into(blocked);
+      bench::do_not_optimize(blocked_text.data());
+    }));
+
+    if (naive_text != blocked_text) {
+      xlog::error("text_matrix_columns: transposes disagree for n={}", n);
+      return;
+    }
+
+    // Tilting north: every column is walked in place, or as a row of a transposed copy that
+    // is then written back
+    auto strided_text = text;
+    xmas::views::text_matrix strided(strided_text);
+    bench::report("text_matrix_columns", std::format("strided tilt {}", n), bench::run([&] {
+      for (std::size_t c = 0; c < n; ++c) {
+        tilt(strided.col(c));
+      }
+      bench::do_not_optimize(strided_text.data());
+    }));
+
+    auto shadow_text = text;
+    xmas::views::text_matrix shadowed(shadow_text);
+    xmas::views::column_major shadow(shadowed);
+    bench::report("text_matrix_columns", std::format("shadow tilt {}", n), bench::run([&] {
+      shadow.invalidate();
+      for (std::size_t c = 0; c < n; ++c) {
+        tilt(shadow.cols().row(c));
+      }
+      shadow.commit();
+      bench::do_not_optimize(shadow_text.data());
+    }));
+
+    if (strided_text != shadow_text) {
+      xlog::error("text_matrix_columns: tilts disagree for n={}", n);
+      return;
+    }
+  }
+});
+
+} // namespace text_matrix_bench
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <doctest/doctest.h>
+
+#include "text_matrix.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+TEST_CASE("Text matrix") {
+  // Pseudo-random matrix, with sizes that are not multiples of the 8×8 blocks
+  const auto make_text = [](std::size_t nrows, std::size_t ncols) {
+    std::string text = xmas::views::text_matrix::blank(nrows, ncols);
+    std::uint64_t state = 42;
+    for (char& ch : text) {
+      state = state * 6364136223846793005u + 1442695040888963407u;
+      if (ch != '\n') {
+        ch = static_cast<char>('a' + (state >> 33) % 26);
+      }
+    }
+    return text;
+  };
+
+  SUBCASE("Transpose") {
+    for (auto [nrows, ncols] : {std::pair<std::size_t, std::size_t>{1, 1}, {3, 5}, {8, 8},
+           {17, 70}, {150, 131}}) {
+      auto text = make_text(nrows, ncols);
+      xmas::views::text_matrix m(text);
+      REQUIRE_EQ(m.nrows(), nrows);
+      REQUIRE_EQ(m.ncols(), ncols);
+
+      auto ttext = m.transposed();
+      xmas::views::text_matrix t(ttext);
+      REQUIRE_EQ(t.nrows(), ncols);
+      REQUIRE_EQ(t.ncols(), nrows);
+
+      for (std::size_t i = 0; i < nrows; ++i) {
+        for (std::size_t j = 0; j < ncols; ++j) {
+          REQUIRE_EQ(t.at(j, i), m.at(i, j));
+        }
+      }
+
+      // Transposing twice is the identity
+      CHECK_EQ(t.transposed(), text);
+    }
+
+    std::string square = xmas::views::text_matrix::blank(4, 4);
+    xmas::views::text_matrix wrong(square);
+    auto text = make_text(4, 5);
+    CHECK_THROWS(xmas::views::text_matrix(text).transpose_into(wrong));
+  }
+
+  SUBCASE("Column-major copy") {
+    std::string text = "abc\ndef\n";
+    xmas::views::text_matrix m(text);
+    xmas::views::column_major shadow(m);
+
+    CHECK_EQ(shadow.cols().line(1), "be");
+
+    // Writes to the copy are only visible after committing them
+    shadow.cols().at(1, 0) = 'X';
+    CHECK_EQ(text, "abc\ndef\n");
+    shadow.commit();
+    CHECK_EQ(text, "aXc\ndef\n");
+
+    // Writes to the matrix are only visible after invalidating the copy
+    m.at(1, 2) = 'Y';
+    CHECK_EQ(shadow.cols().line(2), "cf");
+    shadow.invalidate();
+    CHECK_EQ(shadow.cols().line(2), "cY");
+  }
+}
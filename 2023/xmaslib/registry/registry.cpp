@@ -3,18 +3,31 @@
 namespace xmas {
 
 std::map<int, std::unique_ptr<solution>> solutions{};
+std::map<int, internal::solution_factory> factories{};
 
 std::map<int, std::unique_ptr<solution>> const&
   registered_solutions() noexcept {
   return solutions;
 }
 
+std::unique_ptr<solution> make_solution(int day) {
+  auto it = factories.find(day);
+  if (it == factories.end()) {
+    return nullptr;
+  }
+  return it->second();
+}
+
 namespace internal {
 
 std::map<int, std::unique_ptr<solution>>& registered_solutions() noexcept {
   return solutions;
 }
 
+std::map<int, solution_factory>& solution_factories() noexcept {
+  return factories;
+}
+
 } // namespace internal
 
 } // namespace xmas
\ No newline at end of file
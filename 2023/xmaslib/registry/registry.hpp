@@ -11,8 +11,15 @@ namespace xmas {
 
 std::map<int, std::unique_ptr<solution>> const &registered_solutions() noexcept;
 
+// Creates a new instance of the solution registered for a day, independent from the one in
+// registered_solutions(). Returns nullptr if there is none.
+std::unique_ptr<solution> make_solution(int day);
+
 namespace internal {
 std::map<int, std::unique_ptr<solution>> &registered_solutions() noexcept;
+
+using solution_factory = std::unique_ptr<solution> (*)();
+std::map<int, solution_factory> &solution_factories() noexcept;
 }
 
 template <std::derived_from<xmas::solution> S> void register_solution() {
@@ -26,6 +33,7 @@ template <std::derived_from<xmas::solution> S> void register_solution() {
   }
 
   m[day] = std::unique_ptr<solution>(new S(std::move(s)));
+  internal::solution_factories()[day] = [] { return std::unique_ptr<solution>(new S{}); };
 }
 
 } // namespace xmas
@@ -1,11 +1,13 @@
 #include "solution.hpp"
 
 #include <chrono>
+#include <filesystem>
 #include <format>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 
 #include "../log/log.hpp"
 
@@ -15,9 +17,47 @@ solution::duration solution::time() const {
   return this->time_p1 + this->time_p2;
 }
 
+std::optional<std::uint64_t> solution::answer(int part) const {
+  return part == 1 ? this->p1 : this->p2;
+}
+
+solution::duration solution::part_time(int part) const {
+  return part == 1 ? this->time_p1 : this->time_p2;
+}
+
+namespace {
+solution::part_hooks& hooks() {
+  static solution::part_hooks h{};
+  return h;
+}
+
+bool& input_cache_enabled() {
+  static bool enabled = false;
+  return enabled;
+}
+} // namespace
+
+void solution::set_part_hooks(part_hooks h) {
+  hooks() = std::move(h);
+}
+
+void solution::enable_input_cache(bool enable) {
+  input_cache_enabled() = enable;
+}
+
+arena::statistics solution::scratch_stats() const {
+  return this->scratch.stats();
+}
+
 bool solution::run(bool verbose) noexcept {
   bool success = true;
 
+  this->scratch.reset();
+  this->input_hash.reset();
+  this->p1.reset();
+  this->p2.reset();
+  this->time_p1 = this->time_p2 = duration{};
+
   if (verbose)
     xlog::info("Day {}", this->day());
 
@@ -32,9 +72,12 @@ bool solution::run(bool verbose) noexcept {
   }
 
   try {
+    hooks().before(this->day(), 1);
     const auto start = std::chrono::high_resolution_clock::now();
     const auto result = this->part1();
     this->time_p1 = std::chrono::high_resolution_clock::now() - start;
+    this->p1 = result;
+    hooks().after(this->day(), 1);
 
     if (verbose) {
       xlog::info("result 1: {} ({} μs)", result,
@@ -50,9 +93,12 @@ bool solution::run(bool verbose) noexcept {
   }
 
   try {
+    hooks().before(this->day(), 2);
     const auto start = std::chrono::high_resolution_clock::now();
     const auto result = this->part2();
     this->time_p2 = std::chrono::high_resolution_clock::now() - start;
+    this->p2 = result;
+    hooks().after(this->day(), 2);
 
     if (verbose) {
       xlog::info("Result 2: {} ({} μs)", result,
@@ -72,18 +118,76 @@ bool solution::run(bool verbose) noexcept {
 
 void solution::set_input(std::string_view path) {
   this->data_path = path;
+  this->input_text.reset();
 }
 
-void solution::load() {
-  std::ifstream f(this->data_path.data());
-  if (!f) {
-    throw std::runtime_error(
-      std::format("could not open file {}", this->data_path));
+void solution::set_input_text(std::string text) {
+  this->data_path.clear();
+  this->input_text = std::move(text);
+}
+
+void solution::set_prefetched_input(std::string_view path, std::string text) {
+  this->data_path = path;
+  this->input_text = std::move(text);
+}
+
+std::string solution::cache_path() const {
+  // ./data/NN/input.txt is cached in ./data/NN/.cache/input.txt
+  const std::filesystem::path path(this->data_path);
+  return (path.parent_path() / ".cache" / path.filename()).string();
+}
+
+std::uint64_t solution::hashed_input() {
+  if (!this->input_hash.has_value()) {
+    this->input_hash = cache::hash(this->input);
+  }
+  return *this->input_hash;
+}
+
+bool solution::caching_input() const {
+  return input_cache_enabled() && !this->data_path.empty();
+}
+
+std::optional<cache::reader> solution::load_cached(std::uint32_t version) {
+  if (!this->caching_input()) {
+    return {};
   }
 
-  std::stringstream buff;
-  buff << f.rdbuf();
-  input = std::move(buff).str();
+  auto r = cache::reader::open(this->cache_path(), version, this->hashed_input());
+  if (!r.has_value()) {
+    xlog::debug("no valid input cache for day {} at {}", this->day(), this->cache_path());
+  }
+  return r;
+}
+
+void solution::store_cached(cache::writer const& w, std::uint32_t version) {
+  if (!this->caching_input()) {
+    return;
+  }
+
+  try {
+    w.save(this->cache_path(), version, this->hashed_input());
+  } catch (std::runtime_error& err) {
+    xlog::warning("could not store the input cache of day {}: {}", this->day(), err.what());
+  }
+}
+
+void solution::load() {
+  if (this->input_text.has_value()) {
+    // The text is only used once: later runs read the file again
+    input = std::move(*this->input_text);
+    this->input_text.reset();
+  } else {
+    std::ifstream f(this->data_path.data());
+    if (!f) {
+      throw std::runtime_error(
+        std::format("could not open file {}", this->data_path));
+    }
+
+    std::stringstream buff;
+    buff << f.rdbuf();
+    input = std::move(buff).str();
+  }
 
   if (input.size() == 0) {
     xlog::warning("did not load any data from {}", this->data_path);
@@ -1,10 +1,16 @@
 #pragma once
 
+#include "../arena/arena.hpp"
+#include "../cache/cache.hpp"
+
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <ratio>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 
 namespace xmas {
 
@@ -13,6 +19,11 @@ public:
   virtual int day() = 0;
 
   virtual void set_input(std::string_view path);
+  // Uses the given text as input of the next run instead of reading it from a file
+  void set_input_text(std::string text);
+  // Same as set_input, with the contents of the file already read for the next run (e.g. by
+  // another thread)
+  void set_prefetched_input(std::string_view path, std::string text);
   virtual void load();
   virtual bool run(bool verbose) noexcept;
 
@@ -20,14 +31,54 @@ public:
   using duration = std::chrono::duration<long, std::ratio<1, 1000000000>>;
   virtual duration time() const;
 
+  // Answer and time of a part (1 or 2) in the last run. The answer is empty if it failed.
+  std::optional<std::uint64_t> answer(int part) const;
+  duration part_time(int part) const;
+
+  // Scratch allocations made during the last run
+  arena::statistics scratch_stats() const;
+
+  // Hooks called right before and after every part of every run (outside of
+  // the timed region), for instance to profile it.
+  struct part_hooks {
+    std::function<void(int day, int part)> before = [](int, int) {};
+    std::function<void(int day, int part)> after = [](int, int) {};
+  };
+
+  static void set_part_hooks(part_hooks hooks);
+
+  // Solutions that support it store their parsed input in a binary file next to the text
+  // one, and load it from there on later runs with the same input (see xmaslib/cache).
+  static void enable_input_cache(bool enable);
+
 protected:
   virtual std::uint64_t part1() { throw std::runtime_error("not implemented"); }
   virtual std::uint64_t part2() { throw std::runtime_error("not implemented"); }
 
   std::string input;
 
+  // Whether the parsed input is stored for later runs, so that solutions only serialize it
+  // when it is
+  bool caching_input() const;
+
+  // The parsed input stored by an earlier run, if the input cache is enabled and it was stored
+  // with the same version of the format for this same input
+  std::optional<cache::reader> load_cached(std::uint32_t version);
+
+  // Stores the parsed input for later runs, if the input cache is enabled. Failing to store it
+  // is not an error.
+  void store_cached(cache::writer const& w, std::uint32_t version);
+
+  // Scratch memory for the solvers to opt in to. It is reset at the start of every run.
+  arena scratch;
+
 private:
   std::string data_path;
+  std::optional<std::string> input_text; // Replaces reading the file in the next load
+  std::string cache_path() const;
+
+  std::optional<std::uint64_t> input_hash; // Computed on demand, once per run
+  std::uint64_t hashed_input();
 
   std::optional<std::uint64_t> p1;
   std::optional<std::uint64_t> p2;